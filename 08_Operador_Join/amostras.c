@@ -0,0 +1,69 @@
+// PingPongOS - PingPong Operating System
+//
+// Amostragem comum aos benchmarks (ver amostras.h).
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+#include "amostras.h"
+
+static long long amostras[AMOSTRAS_MAX];  //Em milésimos de ns por operação
+static int n_amostras;                    //Amostras colhidas
+static int max_amostras;                  //Amostras da medida corrente
+static long long operacoes;               //Operações no bloco corrente
+static int operacoes_bloco;               //Operações por bloco da medida corrente
+long long bench_inicio;
+long long bench_ultimo;
+volatile int bench_parar;
+
+long long agora_ns(){
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (long long) ts.tv_sec * 1000000000LL + ts.tv_nsec;
+}
+
+void bench_inicia(int bloco, int n){
+    n_amostras = 0;
+    max_amostras = n < AMOSTRAS_MAX ? n : AMOSTRAS_MAX;
+    operacoes = 0;
+    operacoes_bloco = bloco;
+    bench_inicio = 0;
+    bench_ultimo = 0;
+    bench_parar = 0;
+}
+
+int bench_conta(){
+
+    if(++operacoes < operacoes_bloco){
+        return BENCH_BLOCO;
+    }
+    long long t = agora_ns();
+    int estado = BENCH_BLOCO;
+    if(bench_ultimo){
+        amostras[n_amostras++] = (t - bench_ultimo) * 1000 / operacoes;
+        if(n_amostras == max_amostras){
+            bench_parar = 1;
+            estado = BENCH_FIM;
+        }
+    }
+    else{
+        bench_inicio = t;
+        estado = BENCH_AQUECIDO;
+    }
+    bench_ultimo = t;
+    operacoes = 0;
+    return estado;
+}
+
+static int compara(const void *a, const void *b){
+    long long x = *(long long *) a, y = *(long long *) b;
+    return (x > y) - (x < y);
+}
+
+void bench_ordena(){
+    qsort(amostras, n_amostras, sizeof(long long), compara);
+}
+
+double bench_percentil(int p){
+    return amostras[n_amostras * p / 100] / 1000.0;
+}
@@ -0,0 +1,36 @@
+// PingPongOS - PingPong Operating System
+//
+// Amostragem comum aos benchmarks (pingpong-bench, pingpong-escala): as
+// operações são contadas em blocos, o primeiro bloco é de aquecimento e cada
+// bloco seguinte vira uma amostra em ns por operação.
+
+#ifndef __AMOSTRAS__
+#define __AMOSTRAS__
+
+#define AMOSTRAS_MAX    101         /* maior quantidade de amostras por medida */
+
+// resultado de bench_conta
+#define BENCH_BLOCO     0           /* operação contada (ou bloco comum fechado) */
+#define BENCH_AQUECIDO  1           /* fim do bloco de aquecimento */
+#define BENCH_FIM       2           /* última amostra: bench_parar ligado */
+
+extern long long bench_inicio;      //Instante do fim do aquecimento
+extern long long bench_ultimo;      //Instante do fim do bloco anterior (0: aquecimento)
+extern volatile int bench_parar;    //Todas as amostras colhidas
+
+//Relógio monotônico em ns
+long long agora_ns();
+
+//Prepara uma medida de n_amostras blocos de bloco operações
+void bench_inicia(int bloco, int n_amostras);
+
+//Conta uma operação; fecha um bloco a cada bloco operações
+int bench_conta();
+
+//Ordena as amostras; depois delas, bench_percentil(0) é o mínimo
+void bench_ordena();
+
+//Percentil p das amostras ordenadas, em ns por operação
+double bench_percentil(int p);
+
+#endif
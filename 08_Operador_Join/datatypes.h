@@ -21,6 +21,34 @@ typedef unsigned int sys_clock_t;
 typedef unsigned long long count_t;
 typedef unsigned char bool;
 
+#define HIST_SUB_BITS   3           /* 8 subdivisões por potência de 2: erro máximo de 12,5% */
+#define HIST_OITAVAS    36          /* maior valor registrado: 2^36 ns (~69 s) */
+#define HIST_BALDES     ((HIST_OITAVAS - HIST_SUB_BITS + 2) << HIST_SUB_BITS)
+
+#define PERF_EVENTOS    4           /* ciclos, instruções, falhas de cache, falhas de desvio */
+
+#define TLS_SLOTS       4           /* chaves guardadas no próprio descritor da tarefa */
+#define TLS_CHAVES      64          /* total de chaves (as demais numa tabela alocada por tarefa) */
+
+typedef int task_key_t;             //Chave do armazenamento local das tarefas (task_key_create)
+
+// Histograma em escala logarítmica (no estilo HDR) de durações em ns
+typedef struct pp_hist_t
+{
+    count_t n;                          //Amostras registradas
+    count_t max;                        //Maior amostra
+    unsigned int baldes[HIST_BALDES];
+} pp_hist_t ;
+
+// Grupo de tarefas (group_spawn): aguardadas e canceladas em conjunto
+typedef struct task_group_t
+{
+    int ativas;                         //Tarefas do grupo ainda não encerradas
+    bool cancelado;                     //group_cancel já foi chamada: novas tarefas nascem canceladas
+    struct task_t *membros;             //Tarefas ativas (lista circular por grupo_prox)
+    struct task_t *aguardando;          //Tarefas suspensas em group_wait
+} task_group_t ;
+
 // Estrutura que define uma tarefa
 typedef struct task_t
 {
@@ -28,6 +56,7 @@ typedef struct task_t
     struct task_t *next;    //Tarefa anterior da fila
     int id;                //Id da tarefa
     ucontext_t context;     //Contexto da tarefa
+    void *contexto_sp;      //Pilha salva pela troca de contexto em assembly (TROCA=asm)
     enum status_t status;   //Estado da tarefa
     struct task_t *parent;  //"Pai" da tarefa (tarefa em execução quando esta tarefa foi criada)
     struct queue_t **fila_atual;
@@ -41,11 +70,56 @@ typedef struct task_t
     count_t contador_processo;
 
     int ex_status;
-    struct  task *fila_taguardando;
-    bool lock_p;
+    struct task_t *fila_taguardando;    //Tarefas aguardando o encerramento desta (task_join)
+    int lock_p;                         //Aninhamento de preempt_disable: não é preemptada enquanto > 0
+    bool desacoplada;                   //Tarefa desacoplada (detached): ninguém fará join, recursos liberados ao sair
+
+    int nivel;                          //Nível da tarefa no escalonador multinível (MLFQ)
+    count_t vruntime;                   //Tempo virtual de execução, ponderado pela prioridade (CFS)
+    sys_clock_t vr_marca;               //t_executado quando o vruntime foi atualizado pela última vez
+    int pos_heap;                       //Posição da tarefa no heap de prontas do escalonador
+
+    sys_clock_t rt_periodo;             //Período da tarefa de tempo real em ms (0: tarefa comum)
+    sys_clock_t rt_orcamento;           //Processador garantido a cada período, em ms
+    sys_clock_t rt_restante;            //Orçamento restante no período corrente, em ms
+    sys_clock_t rt_deadline;            //Deadline absoluto do trabalho corrente
+    bool rt_esgotado;                   //O trabalho corrente esgotou o orçamento sem terminar
+    unsigned int rt_perdas;             //Quantidade de deadlines perdidos
+
+    int quantum;                        //Quantum (ticks) escolhido para a tarefa no modo adaptativo
+    int uso_quantum;                    //Média móvel (%) das ativações em que a tarefa esgotou o quantum
+    count_t quantum_total;              //Soma dos quanta recebidos (para a média no relatório)
+
+    sys_clock_t acordar_em;             //Instante em que a tarefa adormecida (task_sleep) acorda
+
+    struct task_t *viva_ant, *viva_prox;    //Lista das tarefas de usuário ainda não encerradas
+    long long pronta_em;                //Instante (ns) em que entrou na fila de prontas (0: não está pronta)
+    pp_hist_t latencia;                 //Espera na fila de prontas até executar
+    count_t perf[PERF_EVENTOS];         //Contadores de desempenho acumulados (pingpong_set_perf)
+
+    void *tls[TLS_SLOTS];               //Valores das primeiras chaves (task_setspecific)
+    void **tls_extra;                   //Valores das chaves seguintes, alocados no primeiro uso
+
+    bool cancelada;                     //Cancelamento pedido: os pontos de cancelamento retornam TASK_CANCELED
+    bool ponto_cancelamento;            //Suspensa num ponto de cancelamento (pode ser acordada pelo cancelamento)
+    task_group_t *grupo;                //Grupo da tarefa (group_spawn), ou NULL
+    struct task_t *grupo_ant, *grupo_prox;  //Lista das tarefas ativas do grupo
 
 } task_t ;
 
+// Política de escalonamento: o escalonador mantém a fila de prontas da forma
+// que preferir; o núcleo só a acessa por estas operações
+typedef struct sched_policy_t
+{
+    const char *nome;
+    void (*task_new) (task_t *task);        //Inicializa os campos da política em uma nova tarefa
+    void (*enqueue) (task_t *task);         //Insere uma tarefa na fila de prontas
+    void (*remove) (task_t *task);          //Retira uma tarefa da fila de prontas
+    task_t *(*pick) ();                     //Escolhe a próxima tarefa (sem retirá-la da fila)
+    void (*stop) (task_t *task, int preemptada); //A tarefa deixou o processador (preemptada: esgotou o quantum)
+    int (*quantum) (task_t *task);          //Ticks do próximo quantum da tarefa
+} sched_policy_t ;
+
 // estrutura que define um semáforo
 typedef struct
 {
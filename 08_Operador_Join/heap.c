@@ -0,0 +1,114 @@
+/*
+ * Heap mínimo de tarefas (ver heap.h).
+ */
+
+#include <stdlib.h>
+
+#include "heap.h"
+
+#define HEAP_CAP_INI    64          /* capacidade inicial do vetor */
+
+static void heap_coloca(task_heap_t *heap, int pos, task_t *task) {
+    heap->v[pos] = task;
+    task->pos_heap = pos;
+}
+
+static void heap_sobe(task_heap_t *heap, int pos) {
+    task_t *task = heap->v[pos];
+
+    while (pos > 0) {
+        int pai = (pos - 1) / 2;
+        if (!heap->menor(task, heap->v[pai])) {
+            break;
+        }
+        heap_coloca(heap, pos, heap->v[pai]);
+        pos = pai;
+    }
+    heap_coloca(heap, pos, task);
+}
+
+static void heap_desce(task_heap_t *heap, int pos) {
+    task_t *task = heap->v[pos];
+
+    for (;;) {
+        int filho = 2 * pos + 1;
+        if (filho >= heap->tam) {
+            break;
+        }
+        if (filho + 1 < heap->tam && heap->menor(heap->v[filho + 1], heap->v[filho])) {
+            filho++;
+        }
+        if (!heap->menor(heap->v[filho], task)) {
+            break;
+        }
+        heap_coloca(heap, pos, heap->v[filho]);
+        pos = filho;
+    }
+    heap_coloca(heap, pos, task);
+}
+
+//------------------------------------------------------------------------------
+// Garante espaço para n tarefas, dobrando a capacidade do vetor.
+
+int heap_reserve(task_heap_t *heap, int n) {
+
+    if (n <= heap->cap) {
+        return 0;
+    }
+    int cap = heap->cap ? heap->cap : HEAP_CAP_INI;
+    while (cap < n) {
+        cap *= 2;
+    }
+    task_t **v = realloc(heap->v, cap * sizeof(task_t *));
+    if (!v) {
+        return -1;
+    }
+    heap->v = v;
+    heap->cap = cap;
+    return 0;
+}
+
+//------------------------------------------------------------------------------
+// Insere uma tarefa no heap, aumentando o vetor se necessário.
+
+int heap_insert(task_heap_t *heap, task_t *task) {
+
+    if (heap->tam == heap->cap && heap_reserve(heap, heap->tam + 1)) {
+        return -1;
+    }
+
+    heap_coloca(heap, heap->tam++, task);
+    heap_sobe(heap, task->pos_heap);
+    return 0;
+}
+
+//------------------------------------------------------------------------------
+// Remove a tarefa indicada do heap: a última tarefa ocupa o seu lugar e é
+// reposicionada.
+
+void heap_remove(task_heap_t *heap, task_t *task) {
+    int pos = task->pos_heap;
+    task_t *ultima = heap->v[--heap->tam];
+
+    task->pos_heap = -1;
+    if (pos == heap->tam) {
+        return;
+    }
+    heap_coloca(heap, pos, ultima);
+    heap_update(heap, ultima);
+}
+
+//------------------------------------------------------------------------------
+// Reposiciona uma tarefa cuja chave mudou enquanto estava no heap.
+
+void heap_update(task_heap_t *heap, task_t *task) {
+    heap_sobe(heap, task->pos_heap);
+    heap_desce(heap, task->pos_heap);
+}
+
+//------------------------------------------------------------------------------
+// Retorna a tarefa de menor chave, ou NULL se o heap estiver vazio
+
+task_t *heap_top(task_heap_t *heap) {
+    return heap->tam ? heap->v[0] : NULL;
+}
@@ -0,0 +1,47 @@
+//------------------------------------------------------------------------------
+// Heap mínimo de tarefas, usado pelos escalonadores que precisam da menor
+// chave em O(1) e de inserção/remoção em O(log n). Cada tarefa guarda sua
+// posição no heap (pos_heap), permitindo remover qualquer tarefa.
+//------------------------------------------------------------------------------
+
+#ifndef __HEAP__
+#define __HEAP__
+
+#include "datatypes.h"
+
+typedef struct task_heap_t {
+    task_t **v;                             // vetor de tarefas
+    int tam;                                // quantidade de tarefas no heap
+    int cap;                                // capacidade alocada
+    int (*menor)(task_t *a, task_t *b);     // ordem do heap: a vem antes de b?
+} task_heap_t;
+
+//------------------------------------------------------------------------------
+// Garante espaço para n tarefas no heap, para que heap_insert não aloque
+// memória (ela pode ser chamada dentro do tratador do timer).
+// Retorno: 0 ou -1 se não houver memória
+
+int heap_reserve(task_heap_t *heap, int n);
+
+//------------------------------------------------------------------------------
+// Insere uma tarefa no heap, aumentando o vetor se necessário.
+// Retorno: 0 ou -1 se não houver memória
+
+int heap_insert(task_heap_t *heap, task_t *task);
+
+//------------------------------------------------------------------------------
+// Remove a tarefa indicada do heap (ela deve estar nele).
+
+void heap_remove(task_heap_t *heap, task_t *task);
+
+//------------------------------------------------------------------------------
+// Reposiciona uma tarefa cuja chave mudou enquanto estava no heap.
+
+void heap_update(task_heap_t *heap, task_t *task);
+
+//------------------------------------------------------------------------------
+// Retorno: tarefa de menor chave, ou NULL se o heap estiver vazio
+
+task_t *heap_top(task_heap_t *heap);
+
+#endif
@@ -0,0 +1,208 @@
+// PingPongOS - PingPong Operating System
+//
+// Estruturas e funções internas do núcleo, compartilhadas entre os módulos
+// do sistema (não devem ser usadas pelas aplicações)
+
+#ifndef __KERNEL__
+#define __KERNEL__
+
+#include <signal.h>
+
+#include "pingpong_config.h"
+#include "pingpong.h"
+#include "heap.h"
+#include "pp_trace.h"
+
+#define STACKSIZE       PP_PILHA    /* tamanho de pilha das threads */
+#define QUANTUM         PP_QUANTUM  /* ticks que compõem um quantum*/
+#define PRIO_MAX        -20         /* valor da prioridade máxima para tarefas */
+#define PRIO_MIN        20          /* valor da prioridade mínima para tarefas */
+
+// marcador de fila_atual para tarefas que estão na fila de prontas do escalonador
+#define FILA_PRONTAS    ((queue_t **) &fila_tprontas)
+
+// marcador de fila_atual para tarefas adormecidas (heap ordenado por acordar_em)
+#define FILA_DORMINDO   ((queue_t **) &dormindo)
+
+// instante "nunca" para os prazos do despachante ocioso
+#define NUNCA           (~(sys_clock_t) 0)
+
+extern task_t tarefa_principal, dispatcher, *tarefa_atual, *fila_tprontas;
+
+extern task_heap_t dormindo;            //Tarefas adormecidas, pela hora de acordar
+extern task_heap_t cfs_heap;            //Tarefas prontas do CFS, por vruntime (sched_cfs.c)
+extern task_heap_t edf_heap;            //Tarefas de tempo real com orçamento, por deadline (sched_edf.c)
+
+extern sched_policy_t *escalonador;     //Política de escalonamento em uso
+extern int n_prontas;                   //Quantidade de tarefas na fila de prontas
+extern int preempcao_tick;              //A troca de contexto em andamento foi causada pelo timer
+extern volatile sig_atomic_t need_resched;  //O timer pediu uma troca durante uma seção crítica
+extern volatile sig_atomic_t em_nucleo;     //Profundidade de entrada no núcleo (filas e estados em alteração)
+extern volatile sig_atomic_t tick_pendente; //Ticks recebidos dentro do núcleo, a processar na saída
+
+//Quantum do próximo turno da tarefa (da política ou adaptativo)
+int task_quantum(task_t *task);
+
+//Processa os ticks adiados enquanto o núcleo estava ocupado
+void kernel_replay();
+
+//Entrada e saída das seções que alteram filas e estados das tarefas: o timer
+//não mexe nessas estruturas enquanto em_nucleo > 0, apenas conta o tick em
+//tick_pendente, que é processado na saída. Custa um incremento e um
+//decremento, sem chamadas de sistema; nunca trocar de contexto dentro delas.
+#define kernel_enter()  do { em_nucleo++; __atomic_signal_fence(__ATOMIC_SEQ_CST); } while(0)
+#define kernel_exit()   do { __atomic_signal_fence(__ATOMIC_SEQ_CST); \
+                             if(!--em_nucleo && tick_pendente) kernel_replay(); } while(0)
+
+//Altera o estado de uma tarefa para PRONTA e adicona na fila de tarefas prontas
+int task_set_ready(task_t* task);
+
+//Retira uma tarefa da fila em que se encontra (fila de prontas ou de espera)
+void task_queue_leave(task_t* task);
+
+// classe de tempo real (sched_edf.c) ==========================================
+extern task_t *edf_espera;              //Tarefas de tempo real aguardando o próximo período
+extern sys_clock_t edf_liberacao;       //Próximo instante em que alguma tarefa de edf_espera é liberada
+
+//Insere/retira uma tarefa de tempo real no heap de deadlines
+void edf_enqueue(task_t *task);
+void edf_remove(task_t *task);
+
+//Coloca uma tarefa de tempo real sem orçamento na espera pelo próximo período
+void edf_throttle(task_t *task);
+
+//Libera as tarefas cujo período recomeçou e retorna a de deadline mais próximo
+task_t *edf_pick();
+
+//Contabiliza um tick da tarefa de tempo real em execução; retorna 1 se o orçamento acabou
+int edf_tick(task_t *task);
+
+// E/S não bloqueante (pp_io.c) ================================================
+extern int io_esperando;                //Tarefas suspensas aguardando um descritor
+extern sys_clock_t io_ultimo_poll;      //Instante da última consulta ao epoll
+
+//Consulta o epoll (esperando até timeout_ms; -1 sem limite) e acorda as
+//tarefas dos descritores prontos. Retorna quantas tarefas acordou
+int io_poll(int timeout_ms);
+
+//Observa um descritor interno do núcleo; aviso é chamada quando ficar legível
+int io_watch(int fd, void (*aviso)(int fd));
+
+//Relógio monotônico em nanossegundos
+long long relogio_ns();
+
+// troca de contexto (pp_troca.c) =============================================
+extern volatile sig_atomic_t em_tratador;   //A tarefa atual está dentro do tratador do timer
+
+//Prepara o contexto de uma tarefa nova, que começará em inicio(arg) na pilha dada
+void contexto_cria(task_t *task, char *pilha, void (*inicio)(void*), void *arg);
+
+//Salva o contexto de sai e retoma entra
+void contexto_troca(task_t *sai, task_t *entra);
+
+// estatísticas (pp_stats.c) ===================================================
+
+//Tarefas de usuário ainda não encerradas (lista circular por viva_prox)
+extern task_t *tarefas_vivas;
+
+//Contadores globais, incrementados direto pelo núcleo (vivas, prontas e
+//relogio são preenchidos na amostra)
+extern struct pp_stats pp_contadores;
+
+//Inclui uma tarefa de usuário nas estatísticas, ao ser criada
+void stats_task_new(task_t *task);
+
+//Retira uma tarefa encerrada da lista de tarefas vivas
+void stats_task_exit(task_t *task);
+
+//A tarefa entrou na fila de prontas
+void stats_pronta(task_t *task);
+
+//A tarefa foi despachada: registra quanto esperou na fila de prontas
+void stats_executa(task_t *task);
+
+//Soma n a um contador de pp_contadores; removido com ESTATISTICAS=0, assim
+//como os ganchos acima
+#if PP_ESTATISTICAS
+#define CONTA(campo, n)     (pp_contadores.campo += (n))
+#else
+#define CONTA(campo, n)     ((void) 0)
+#define stats_task_new(task)    ((void) 0)
+#define stats_task_exit(task)   ((void) 0)
+#define stats_pronta(task)      ((void) 0)
+#define stats_executa(task)     ((void) 0)
+#endif
+
+//Registra uma duração em ns no histograma
+void hist_registra(pp_hist_t *h, long long ns);
+
+//Duração abaixo da qual estão a fração p (0 a 1) das amostras
+long long hist_percentil(pp_hist_t *h, double p);
+
+// contadores de desempenho (pp_perf.c) =======================================
+extern int perf_ativo;                  //Contadores abertos
+
+//Atribui à tarefa que deixa o processador os eventos desde a última troca
+void perf_troca(task_t *task);
+
+//Zera os contadores de uma tarefa nova (descritores reutilizados por task_create)
+void perf_task_init(task_t *task);
+
+//Liga os contadores se PINGPONG_PERF estiver definida; chamada por pingpong_init
+void perf_init();
+
+// grupos de tarefas (pp_grupo.c) =============================================
+
+//Retira a tarefa que encerra do seu grupo e acorda quem aguarda o grupo, se
+//era a última (dentro do núcleo, em task_exit)
+void grupo_task_exit(task_t *task);
+
+// armazenamento local das tarefas (pp_tls.c) ================================
+
+//Chama os destrutores dos valores da tarefa que encerra e libera sua tabela
+void tls_task_exit(task_t *task);
+
+// rastreamento (pp_trace.c) ===================================================
+
+//Liga o rastreamento se PINGPONG_TRACE estiver definida; chamada por pingpong_init
+void trace_init();
+
+// trabalhos executados fora da thread das tarefas (pp_pool.c, pp_aio.c) =======
+
+// trabalho entregue às threads auxiliares ou ao io_uring; fica na pilha da
+// tarefa que o espera, suspensa até a conclusão
+typedef struct pool_job_t
+{
+    struct pool_job_t *prox;
+    void (*executa) (struct pool_job_t *job);   //Executada por uma thread auxiliar
+    task_t *task;                       //Tarefa suspensa aguardando o trabalho
+    long resultado;                     //Retorno da operação
+    int erro;                           //errno da operação (0 se não houve erro)
+    int op;                             //Operação de arquivo (AIO_LEITURA, ...)
+    int fd;
+    void *buf;                          //Buffer da operação ou argumento de funcao
+    size_t tam;
+    off_t pos;
+    void *(*funcao) (void *);           //Função de task_offload
+    void *retorno;                      //Retorno de funcao
+} pool_job_t ;
+
+extern int aio_pendentes;               //Trabalhos submetidos e ainda não concluídos
+
+//Entrega um trabalho às threads auxiliares. Retorna 0 ou -1 se não há threads
+int pool_submit(pool_job_t *job);
+
+//Suspende a tarefa corrente até o trabalho ser concluído (aio_done)
+void aio_wait(pool_job_t *job);
+
+//Conclui um trabalho: acorda a tarefa que o esperava
+void aio_done(pool_job_t *job);
+
+//Submete as operações enfileiradas e colhe as conclusões (io_uring e threads
+//auxiliares); chamada pelo despachante a cada escolha de tarefa
+void aio_dispatch();
+
+//Colhe os trabalhos concluídos pelas threads auxiliares
+void pool_drain();
+
+#endif
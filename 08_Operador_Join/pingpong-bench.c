@@ -0,0 +1,155 @@
+// PingPongOS - PingPong Operating System
+//
+// Microbenchmarks do núcleo: cada medida é repetida em AMOSTRAS blocos de
+// operações e o resultado é mostrado em ns por operação (mínimo, mediana e
+// percentil 99 dos blocos).
+//
+// uso: pingpong-bench [prio|mlfq|cfs] [N máximo de tarefas prontas]
+// (para resultados reproduzíveis, fixe o processo numa CPU: taskset -c 0)
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "pingpong.h"
+#include "amostras.h"
+
+#define AMOSTRAS    101         /* blocos medidos por benchmark (mais um de aquecimento) */
+#define BLOCO       2000        /* operações por bloco */
+#define N_PADRAO    100000      /* maior fila de prontas medida por padrão */
+
+//Mostra mínimo, mediana e p99 das amostras
+void bench_mostra(const char *nome, long n){
+
+    bench_ordena();
+    char rotulo[64];
+    if(n){
+        snprintf(rotulo, sizeof(rotulo), "%s (N=%ld)", nome, n);
+    }
+    else{
+        snprintf(rotulo, sizeof(rotulo), "%s", nome);
+    }
+    printf("%-32s %10.1f %10.1f %10.1f\n", rotulo, bench_percentil(0),
+        bench_percentil(50), bench_percentil(99));
+}
+
+// task_yield entre duas tarefas ===============================================
+
+void corpo_yield(void *arg){
+    (void) arg;
+    while(!bench_parar){
+        bench_conta();
+        task_yield();
+    }
+    task_exit(0);
+}
+
+void bench_yield(){
+    task_t a, b;
+
+    bench_inicia(BLOCO, AMOSTRAS);
+    task_create(&a, corpo_yield, NULL);
+    task_create(&b, corpo_yield, NULL);
+    task_join(&a);
+    task_join(&b);
+    bench_mostra("yield ping-pong", 0);
+}
+
+// task_create + task_exit + task_join ==========================================
+
+void corpo_vazio(void *arg){
+    (void) arg;
+    task_exit(0);
+}
+
+void bench_create(){
+    task_t t;
+
+    bench_inicia(BLOCO / 10, AMOSTRAS);
+    while(!bench_parar){
+        task_create(&t, corpo_vazio, NULL);
+        task_join(&t);
+        bench_conta();
+    }
+    bench_mostra("create+exit+join", 0);
+}
+
+// entrega entre duas tarefas por suspend/resume ================================
+
+task_t *espera;                 //Tarefa suspensa aguardando a vez
+
+void corpo_entrega(void *arg){
+    (void) arg;
+    while(!bench_parar){
+        bench_conta();
+        if(espera){
+            task_resume(espera);
+        }
+        task_suspend(NULL, &espera);
+    }
+    if(espera){
+        task_resume(espera);
+    }
+    task_exit(0);
+}
+
+void bench_entrega(){
+    task_t a, b;
+
+    bench_inicia(BLOCO, AMOSTRAS);
+    espera = NULL;
+    task_create(&a, corpo_entrega, NULL);
+    task_create(&b, corpo_entrega, NULL);
+    task_join(&a);
+    task_join(&b);
+    bench_mostra("suspend/resume handoff", 0);
+}
+
+// despacho com N tarefas prontas ===============================================
+
+void bench_despacho(long n){
+
+    task_t *tarefas = calloc(n, sizeof(task_t));
+    if(!tarefas){
+        perror("Erro ao alocar as tarefas: ");
+        exit(-1);
+    }
+
+    long bloco = BLOCO * 10 / n;        //Blocos menores para filas grandes (políticas O(n) por escolha)
+    bench_inicia(bloco < 10 ? 10 : bloco > BLOCO ? BLOCO : bloco, AMOSTRAS);
+    preempt_disable();                  //Nenhuma tarefa executa (nem mede) antes da fila estar completa
+    for(long i = 0; i < n; i++){
+        if(task_create(&tarefas[i], corpo_yield, NULL) < 0){
+            fprintf(stderr, "Sem memória para %ld tarefas\n", n);
+            exit(-1);
+        }
+    }
+    preempt_enable();
+    for(long i = 0; i < n; i++){
+        task_join(&tarefas[i]);
+    }
+    bench_mostra("dispatch", n);
+    free(tarefas);
+}
+
+int main(int argc, char *argv[]){
+
+    if(argc > 1){
+        sched_policy_t *politica = !strcmp(argv[1], "mlfq") ? &sched_mlfq :
+                                   !strcmp(argv[1], "cfs") ? &sched_cfs : &sched_prio;
+        pingpong_set_scheduler(politica);
+    }
+    long n_max = argc > 2 ? atol(argv[2]) : N_PADRAO;
+
+    pingpong_init();
+
+    printf("%-32s %10s %10s %10s\n", "ns/op", "min", "median", "p99");
+    bench_yield();
+    bench_create();
+    bench_entrega();
+    for(long n = 10; n <= n_max; n *= 10){
+        bench_despacho(n);
+    }
+
+    task_exit(0);
+    return 0;
+}
@@ -0,0 +1,86 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include "pingpong.h"
+
+// cancelamento de tarefas: cada tarefa espera num ponto de cancelamento
+// diferente (task_sleep, task_join, task_yield, group_wait); task_cancel e
+// group_cancel as acordam, o ponto retorna TASK_CANCELED e a tarefa encerra
+// com exit code 1 se o recebeu. Os membros do grupo só cedem o processador
+// até o group_cancel.
+
+task_t Dorme, Junta, Gira, Espera, Membro[3] ;
+task_group_t Grupo ;
+
+void BodyDorme (void * arg)
+{
+   (void) arg ;
+   task_exit (task_sleep (100) == TASK_CANCELED) ;
+}
+
+void BodyJunta (void * arg)
+{
+   (void) arg ;
+   task_exit (task_join (&Dorme) == TASK_CANCELED) ;
+}
+
+void BodyGira (void * arg)
+{
+   int ret ;
+
+   (void) arg ;
+   while (!(ret = task_yield ())) ;
+   task_exit (ret == TASK_CANCELED) ;
+}
+
+void BodyMembro (void * arg)
+{
+   (void) arg ;
+   while (!task_yield ()) ;
+   task_exit (0) ;
+}
+
+void BodyEspera (void * arg)
+{
+   int i ;
+
+   (void) arg ;
+   group_init (&Grupo) ;
+   for (i=0; i<3; i++)
+      group_spawn (&Grupo, &Membro[i], BodyMembro, NULL) ;
+   task_exit (group_wait (&Grupo) == TASK_CANCELED) ;
+}
+
+int main (int argc, char *argv[])
+{
+   (void) argc ;
+   (void) argv ;
+
+   pingpong_init () ;
+
+   printf ("Main INICIO\n") ;
+
+   task_create (&Dorme, BodyDorme, NULL) ;
+   task_create (&Junta, BodyJunta, NULL) ;
+   task_create (&Gira, BodyGira, NULL) ;
+   task_create (&Espera, BodyEspera, NULL) ;
+   task_sleep (0) ;                        // todas chegam ao ponto de cancelamento
+
+   printf ("Cancela Junta: %d\n", task_cancel (&Junta)) ;
+   printf ("Junta encerrou com exit code %d\n", task_join (&Junta)) ;
+
+   printf ("Cancela Dorme: %d\n", task_cancel (&Dorme)) ;
+   printf ("Cancela Gira: %d\n", task_cancel (&Gira)) ;
+   printf ("Dorme encerrou com exit code %d\n", task_join (&Dorme)) ;
+   printf ("Gira encerrou com exit code %d\n", task_join (&Gira)) ;
+   printf ("Cancela Dorme de novo: %d\n", task_cancel (&Dorme)) ;
+
+   printf ("Cancela Espera: %d\n", task_cancel (&Espera)) ;
+   printf ("Espera encerrou com exit code %d\n", task_join (&Espera)) ;
+   printf ("Cancela o grupo: %d tarefas\n", group_cancel (&Grupo)) ;
+   printf ("Grupo aguardado: %d\n", group_wait (&Grupo)) ;
+
+   printf ("Main FIM\n") ;
+   task_exit (0) ;
+
+   exit (0) ;
+}
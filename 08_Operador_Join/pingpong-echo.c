@@ -0,0 +1,136 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <netinet/in.h>
+#include <arpa/inet.h>
+#include "pingpong.h"
+
+// servidor de eco TCP: cada conexão é atendida por uma tarefa; os clientes
+// enviam mensagens e conferem a resposta, enquanto uma tarefa calcula sem
+// fazer E/S. Nenhuma operação bloqueia o processo (pp_read, pp_write...).
+
+#define CLIENTES  5
+#define MENSAGENS 100
+
+task_t Servidor, Cliente[CLIENTES], Conexao[CLIENTES], Calculo ;
+
+int escuta, porta ;
+int erros[CLIENTES] ;
+
+void Atende (void * arg)
+{
+   int fd = (int) (long) arg ;
+   char buf[64] ;
+   ssize_t n ;
+
+   while ((n = pp_read (fd, buf, sizeof buf)) > 0)
+      pp_write (fd, buf, n) ;
+   pp_close (fd) ;
+   task_exit (0) ;
+}
+
+void BodyServidor (void * arg)
+{
+   int i, fd ;
+
+   (void) arg ;
+   for (i=0; i<CLIENTES; i++)
+   {
+      fd = pp_accept (escuta, NULL, NULL) ;
+      if (fd < 0)
+      {
+         perror ("pp_accept") ;
+         exit (1) ;
+      }
+      task_create_flags (&Conexao[i], Atende, (void *) (long) fd, TASK_DETACHED) ;
+   }
+   task_exit (0) ;
+}
+
+void BodyCliente (void * arg)
+{
+   long id = (long) arg ;
+   struct sockaddr_in end ;
+   char msg[32], resp[32] ;
+   ssize_t n ;
+   int s, k ;
+
+   s = socket (AF_INET, SOCK_STREAM, 0) ;
+   memset (&end, 0, sizeof end) ;
+   end.sin_family = AF_INET ;
+   end.sin_port = htons (porta) ;
+   end.sin_addr.s_addr = htonl (INADDR_LOOPBACK) ;
+   if (pp_connect (s, (struct sockaddr *) &end, sizeof end) < 0)
+   {
+      perror ("pp_connect") ;
+      exit (1) ;
+   }
+
+   for (k=0; k<MENSAGENS; k++)
+   {
+      sprintf (msg, "cliente %ld mensagem %d", id, k) ;
+      pp_write (s, msg, strlen (msg)) ;
+      n = pp_read (s, resp, sizeof resp) ;
+      if (n != (ssize_t) strlen (msg) || memcmp (msg, resp, n))
+         erros[id]++ ;
+   }
+   pp_close (s) ;
+   task_exit (MENSAGENS - erros[id]) ;
+}
+
+void BodyCalculo (void * arg)
+{
+   volatile long i ;
+
+   (void) arg ;
+   for (i=0; i<50000000; i++) ;
+   task_exit (0) ;
+}
+
+int main (int argc, char *argv[])
+{
+   struct sockaddr_in end ;
+   socklen_t tam = sizeof end ;
+   long i ;
+   int ret ;
+
+   (void) argc ;
+   (void) argv ;
+
+   pingpong_init () ;
+
+   printf ("Main INICIO\n") ;
+
+   escuta = socket (AF_INET, SOCK_STREAM, 0) ;
+   memset (&end, 0, sizeof end) ;
+   end.sin_family = AF_INET ;
+   end.sin_addr.s_addr = htonl (INADDR_LOOPBACK) ;
+   if (escuta < 0 || bind (escuta, (struct sockaddr *) &end, sizeof end) < 0
+       || getsockname (escuta, (struct sockaddr *) &end, &tam) < 0
+       || listen (escuta, CLIENTES) < 0)
+   {
+      perror ("socket") ;
+      exit (1) ;
+   }
+   porta = ntohs (end.sin_port) ;
+
+   task_create (&Servidor, BodyServidor, NULL) ;
+   task_create (&Calculo, BodyCalculo, NULL) ;
+   for (i=0; i<CLIENTES; i++)
+      task_create (&Cliente[i], BodyCliente, (void *) i) ;
+
+   for (i=0; i<CLIENTES; i++)
+   {
+      ret = task_join (&Cliente[i]) ;
+      printf ("Cliente %ld: %d de %d respostas corretas\n", i, ret, MENSAGENS) ;
+   }
+   task_join (&Servidor) ;
+   task_join (&Calculo) ;
+   pp_close (escuta) ;
+
+   printf ("Main FIM\n") ;
+   task_exit (0) ;
+
+   exit (0) ;
+}
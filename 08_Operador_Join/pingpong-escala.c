@@ -0,0 +1,133 @@
+// PingPongOS - PingPong Operating System
+//
+// Escalabilidade do escalonador: N tarefas que só cedem o processador, com
+// prioridades distribuídas de forma uniforme, todas iguais ou bimodal. Para
+// cada N e distribuição mede o custo de um despacho (mínimo, mediana e p99
+// dos blocos medidos) e as trocas de contexto por segundo, em CSV.
+//
+// uso: pingpong-escala [prio|mlfq|cfs] [N máximo] [-s]   (-s: sem cabeçalho)
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "pingpong.h"
+#include "amostras.h"
+
+#define AMOSTRAS    51          /* blocos medidos por ponto (mais um de aquecimento) */
+#define BLOCO       2000        /* despachos por bloco com poucas tarefas */
+#define N_PADRAO    10000       /* maior quantidade de tarefas por padrão */
+
+enum { UNIFORME, IGUAIS, BIMODAL, DISTRIBUICOES };
+const char *nomes[DISTRIBUICOES] = { "uniforme", "iguais", "bimodal" };
+
+unsigned long long trocas_inicio, trocas_fim;     //Trocas de contexto no início e no fim da medida
+
+//Conta um despacho; as trocas de contexto contam do fim do aquecimento à última amostra
+void conta(){
+
+    struct pp_stats s;
+    switch(bench_conta()){
+        case BENCH_AQUECIDO:
+            pingpong_get_stats(&s);
+            trocas_inicio = s.trocas;
+            break;
+        case BENCH_FIM:
+            pingpong_get_stats(&s);
+            trocas_fim = s.trocas;
+            break;
+    }
+}
+
+void corpo(void *arg){
+    (void) arg;
+    while(!bench_parar){
+        conta();
+        task_yield();
+    }
+    task_exit(0);
+}
+
+//Prioridade da i-ésima tarefa na distribuição
+int prioridade(int dist, long i){
+    switch(dist){
+        case UNIFORME:  return rand() % 41 - 20;
+        case BIMODAL:   return (i % 2) ? 15 : -15;
+        default:        return 0;
+    }
+}
+
+void mede(const char *politica, int dist, long n){
+
+    task_t *tarefas = calloc(n, sizeof(task_t));
+    if(!tarefas){
+        perror("Erro ao alocar as tarefas: ");
+        exit(-1);
+    }
+
+    long bloco = BLOCO * 10 / n;        //Blocos menores para filas grandes (políticas O(n) por escolha)
+    bench_inicia(bloco < 10 ? 10 : bloco > BLOCO ? BLOCO : bloco, AMOSTRAS);
+    srand(1);                           //Mesmas prioridades a cada execução
+
+    //Nenhuma tarefa executa (nem mede) antes da fila estar completa, e cada uma
+    //entra na fila de prontas já com a prioridade da distribuição
+    task_t *criadas = NULL;
+    preempt_disable();
+    for(long i = 0; i < n; i++){
+        if(task_create(&tarefas[i], corpo, NULL) < 0){
+            fprintf(stderr, "Sem memória para %ld tarefas\n", n);
+            exit(-1);
+        }
+        task_suspend(&tarefas[i], &criadas);
+        task_setprio(&tarefas[i], prioridade(dist, i));
+    }
+    while(criadas){
+        task_resume(criadas);
+    }
+    preempt_enable();
+    for(long i = 0; i < n; i++){
+        task_join(&tarefas[i]);
+    }
+
+    double segundos = (bench_ultimo - bench_inicio) / 1e9;
+
+    bench_ordena();
+    printf("%s,%s,%ld,%.1f,%.1f,%.1f,%.0f\n", politica, nomes[dist], n,
+        bench_percentil(0), bench_percentil(50), bench_percentil(99),
+        (trocas_fim - trocas_inicio) / segundos);
+    free(tarefas);
+}
+
+int main(int argc, char *argv[]){
+
+    const char *politica = "prio";
+    long n_max = N_PADRAO;
+    int cabecalho = 1;
+
+    for(int i = 1; i < argc; i++){
+        if(!strcmp(argv[i], "-s")){
+            cabecalho = 0;
+        }
+        else if(!strcmp(argv[i], "mlfq") || !strcmp(argv[i], "cfs") || !strcmp(argv[i], "prio")){
+            politica = argv[i];
+        }
+        else{
+            n_max = atol(argv[i]);
+        }
+    }
+    pingpong_set_scheduler(!strcmp(politica, "mlfq") ? &sched_mlfq :
+                           !strcmp(politica, "cfs") ? &sched_cfs : &sched_prio);
+
+    pingpong_init();
+
+    if(cabecalho){
+        printf("politica,distribuicao,n,despacho_ns_min,despacho_ns_p50,despacho_ns_p99,trocas_por_s\n");
+    }
+    for(int dist = 0; dist < DISTRIBUICOES; dist++){
+        for(long n = 10; n <= n_max; n *= 10){
+            mede(politica, dist, n);
+        }
+    }
+
+    task_exit(0);
+    return 0;
+}
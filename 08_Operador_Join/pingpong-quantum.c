@@ -0,0 +1,77 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include "pingpong.h"
+
+// quantum adaptativo (pingpong_set_quantum): tarefas que esgotam sempre o
+// quantum devem chegar ao máximo, e a que sempre cede o processador, ao piso
+// (o mínimo, aqui maior que o custo de uma troca de contexto)
+
+#define QUANTUM_MIN  2
+#define QUANTUM_MAX  20
+#define GIRANDO      4
+
+task_t Gira[GIRANDO], Cede ;
+
+volatile int fim = 0 ;
+
+void BodyGira (void * arg)
+{
+   (void) arg ;
+   while (!fim) ;
+   task_exit (0) ;
+}
+
+void BodyCede (void * arg)
+{
+   (void) arg ;
+   while (!fim)
+      task_yield () ;
+   task_exit (0) ;
+}
+
+// quantum do próximo turno da tarefa, segundo pingpong_get_task_stats
+int quantum (task_t *task)
+{
+   struct pp_task_stats v[GIRANDO + 3] ;
+   int i, n ;
+
+   n = pingpong_get_task_stats (v, GIRANDO + 3) ;
+   for (i=0; i<n; i++)
+      if (v[i].id == task->id)
+         return v[i].quantum ;
+   return -1 ;
+}
+
+int main (int argc, char *argv[])
+{
+   int i ;
+
+   (void) argc ;
+   (void) argv ;
+
+   pingpong_set_quantum (QUANTUM_MIN, QUANTUM_MAX) ;
+   pingpong_init () ;
+
+   printf ("Main INICIO\n") ;
+
+   for (i=0; i<GIRANDO; i++)
+      task_create (&Gira[i], BodyGira, NULL) ;
+   task_create (&Cede, BodyCede, NULL) ;
+
+   task_sleep (3) ;                        // várias ativações de cada tarefa
+
+   for (i=0; i<GIRANDO; i++)
+      printf ("Gira %d: quantum %s\n", i,
+              quantum (&Gira[i]) == QUANTUM_MAX ? "maximo" : "ABAIXO DO MAXIMO") ;
+   printf ("Cede: quantum %s\n", quantum (&Cede) == QUANTUM_MIN ? "minimo" : "ACIMA DO MINIMO") ;
+
+   fim = 1 ;
+   for (i=0; i<GIRANDO; i++)
+      task_join (&Gira[i]) ;
+   task_join (&Cede) ;
+
+   printf ("Main FIM\n") ;
+   task_exit (0) ;
+
+   exit (0) ;
+}
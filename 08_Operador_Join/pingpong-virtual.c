@@ -0,0 +1,55 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include "pingpong.h"
+
+// relógio virtual (compilado com -DPP_RELOGIO_VIRTUAL): o tempo só avança
+// com pp_advance e com task_sleep, então a preempção, os instantes mostrados
+// e o relatório de saída das tarefas são idênticos a cada execução.
+// make verifica-virtual compara a saída com pingpong-virtual.txt.
+
+#ifndef PP_RELOGIO_VIRTUAL
+#error "compile com -DPP_RELOGIO_VIRTUAL (make virtual)"
+#endif
+
+task_t Pang, Peng, Ping ;
+
+void Body (void * arg)
+{
+   int i, passo ;
+
+   passo = (int) (long) arg ;
+   for (i=0; i<60; i++)
+   {
+      pp_advance (passo) ;                 // "custo" de cada iteração, em ticks
+      if (i % 20 == 0)
+         printf ("Tarefa %d: iteracao %d em %u ms\n", passo, i, systime ()) ;
+   }
+   task_sleep (5) ;
+   printf ("Tarefa %d: acordou em %u ms\n", passo, systime ()) ;
+   task_exit (passo) ;
+}
+
+int main (int argc, char *argv[])
+{
+   (void) argc ;
+   (void) argv ;
+
+   pingpong_init () ;
+
+   printf ("Main INICIO\n") ;
+
+   task_create (&Pang, Body, (void *) 1L) ;
+   task_create (&Peng, Body, (void *) 2L) ;
+   task_create (&Ping, Body, (void *) 3L) ;
+   task_setprio (&Pang, -3) ;
+   task_setprio (&Ping, 3) ;
+
+   printf ("Pang encerrou com exit code %d\n", task_join (&Pang)) ;
+   printf ("Peng encerrou com exit code %d\n", task_join (&Peng)) ;
+   printf ("Ping encerrou com exit code %d\n", task_join (&Ping)) ;
+
+   printf ("Main FIM em %u ms\n", systime ()) ;
+   task_exit (0) ;
+
+   exit (0) ;
+}
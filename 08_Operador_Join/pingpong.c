@@ -1,35 +1,33 @@
 #include "pingpong.h"
+#include "kernel.h"
 #include "queue.h"
+#include "heap.h"
 #include <stdlib.h>
 #include <stdio.h>
 #include <ucontext.h>
 //p005=======================================================
 #include <signal.h>
 #include <sys/time.h>
+#include <time.h>
 //===========================================================
 //#define DEBUG_ALL             //    > ativa todos debugs
-//#define DEBUG
-//DEBUG_OPERATIONAL_SYSTEM  > ativa mensagens do estado do sistema operacional
-//#define DEBUG_TASK_CREATE        // > ativa debugs para criacao de tarefa
+#ifndef PP_SEM_RELATORIO          //    > RELATORIO=0 (pingpong_config.h) desliga o relatório de saída
 #define DEBUG_TASK_EXIT         //  > ativa debugs para finalizacao de tarefa
 #define DEBUG_TASK_EXIT_STATUS   // > ativa mensagem de estado da tarefa em sua finalizacao
-//#define DEBUG_TASK_SWITCH         //> ativa debug para troca de tarefas
-//DEBUG_TASK_SUSPEND        > ativas debug para suspensao de tarefas
-//#define DEBUG_DISPATCHER        //  > habilita debug do dispatcher
-//DEBUG_TASK_PRIORITIES     > habilita debug para prioridades de tarefas
+#endif
 //#define DEBUG_SYSTEM_TASK      //   > habilita mensagens para tarefas de sistema
-//DEBUG_MINIMAL             > mostra principais mensagens de debug
+//Os demais eventos do núcleo são pontos de rastreamento TRACE (pp_trace.h),
+//ligados em tempo de execução com pingpong_trace ou PINGPONG_TRACE=<arquivo>
 
-#define STACKSIZE 32768		/* tamanho de pilha das threads */
-#define ALPHA -1            /* taxa de envelhecimento de tarefas */
+#define ALPHA PP_ENVELHECIMENTO     /* taxa de envelhecimento de tarefas */
 #define ERROR 32          /* buffer de string para mensagem de erro */
 #define STANDARD_PRIO 0          /* valor padrão de prioridade ao criar uma tarefa */
-#define PRIO_MAX -20        /* valor da prioridade máxima para tarefas */
-#define PRIO_MIN 20         /* valor da prioridade mínima para tarefas */
 //p05=======================================================
-#define TICK_SEG       0           /* segundos que compoem um tick (somando com TICK_MICROS)*/
-#define TICK_MSEG     1000        /* microssegundos que compoem um tick (somando com TICK_SECS)- 1 milissegundo neste caso*/
-#define QUANTUM         20          /* ticks que compõem um quantum*/
+#define TICK_SEG      (PP_TICK_MS / 1000)           /* segundos que compoem um tick (somando com TICK_MSEG)*/
+#define TICK_MSEG     (PP_TICK_MS % 1000 * 1000)    /* microssegundos que compoem um tick (somando com TICK_SEG)*/
+#define STACK_POOL_MAX  32          /* pilhas de tarefas encerradas guardadas para reuso */
+#define ADAPT_FILA      4           /* tarefas prontas a partir das quais o quantum adaptativo é pleno */
+#define ADAPT_CUSTO     100         /* o quantum deve ser ao menos ADAPT_CUSTO vezes o custo de uma troca */
 
 ///Variáveis globais    ========================================================
 task_t tarefa_principal, dispatcher, *tarefa_atual = NULL, *fila_tprontas = NULL;     //Tarefa em execução
@@ -40,6 +38,10 @@ int userTasks = 0;      //Contador de tarefas de usuário ativas
 int id_count = 0;       //Contador de IDs
 //p05======================================================================
 int quantum_count = 0; //Contador de ticks para chegar a um quantum
+int preempcao_tick = 0; //A troca de contexto em andamento foi causada pelo fim do quantum
+volatile sig_atomic_t need_resched = 0; //Quantum acabou com a preempção desativada: trocar em preempt_enable
+volatile sig_atomic_t em_nucleo = 0;    //Profundidade de entrada no núcleo (ver kernel_enter)
+volatile sig_atomic_t tick_pendente = 0;    //Ticks adiados por chegarem dentro do núcleo
 
 // estrutura que define um tratador de sinal (deve ser global ou static)
 struct sigaction action ;
@@ -50,6 +52,23 @@ struct itimerval timer;
 //p06=====================================================================
 sys_clock_t sys_clock_ms = 0;   //tempo do sistema em ms
 
+//p08=====================================================================
+task_t *tarefa_reciclar = NULL; //Tarefa desacoplada encerrada, aguardando a troca de contexto para liberar sua pilha
+void *pilhas_livres = NULL;     //Pilhas de tarefas encerradas disponíveis para reuso (lista encadeada na própria pilha)
+int n_pilhas_livres = 0;        //Quantidade de pilhas em pilhas_livres
+
+sched_policy_t *escalonador = &PP_ESCALONADOR;  //Política de escalonamento em uso (padrão de pingpong_config.h)
+int n_prontas = 0;                          //Quantidade de tarefas na fila de prontas
+
+//Ordem do heap de adormecidas: quem acorda primeiro
+int dormindo_menor(task_t *a, task_t *b){
+    return a->acordar_em < b->acordar_em;
+}
+task_heap_t dormindo = { NULL, 0, 0, dormindo_menor };  //Tarefas adormecidas (task_sleep)
+
+int quantum_min = 0, quantum_max = 0;       //Limites do quantum adaptativo (0: desativado)
+long custo_troca_ns = 0;                    //Média móvel do custo do despachante por troca (ns)
+
 
 ///Funções P03 ============================================================
 //inicializa o temporizador do sistema //p06
@@ -70,9 +89,6 @@ void dispatcher_body(void *arg);
 //Despachante de tarefas
 task_t *scheduler();
 
-//Altera o estado de uma tarefa para PRONTA e adicona na fila de tarefas prontas
-int task_set_ready(task_t* task);
-
 //Altera o estado de uma tarefa para EXECUTANDO e à retira da fila da qual pertence
 int task_set_executing(task_t* task);
 
@@ -99,6 +115,41 @@ int task_compare(task_t *task1, task_t *task2);
 //Ordena uma lista de tarefas
 task_t* prioridade_max(task_t **task_q, int task_comp(task_t*,task_t*));
 
+///Funções P08 ============================================================
+//Obtém uma pilha para uma nova tarefa, reaproveitando pilhas liberadas
+char *stack_alloc();
+
+//Devolve uma pilha ao conjunto de pilhas livres
+void stack_release(char *stack);
+
+//Libera os recursos de uma tarefa encerrada (a tarefa não pode estar em execução)
+void task_release(task_t *task);
+
+//Libera a tarefa desacoplada que encerrou antes da última troca de contexto
+void task_reclaim_pending();
+
+//Quantum do próximo turno da tarefa (da política ou adaptativo)
+int task_quantum(task_t *task);
+
+//Recalcula o quantum adaptativo de uma tarefa que deixou o processador
+void task_adapt_quantum(task_t *task, int preemptada);
+
+//Relógio monotônico em nanossegundos (medição do custo das trocas)
+long long relogio_ns();
+
+//Contabiliza um tick na tarefa atual; retorna 1 se ela deve deixar o processador
+int tick_account();
+
+//Troca para o despachante, ou adia a troca se a preempção estiver desativada
+void tick_preempt();
+
+//Acorda as tarefas adormecidas cujo prazo venceu
+void task_wake_sleepers();
+
+//Sem tarefas prontas: bloqueia o processo até o próximo prazo; retorna 0 se
+//nenhuma tarefa puder mais acordar
+int dispatcher_idle();
+
 
 
 // funções gerais ==============================================================
@@ -107,6 +158,9 @@ void pingpong_init (){
     //desativa o buffer de saida padrao (stdout), usado pela função printf
     setvbuf(stdout, 0, _IONBF, 0);
 
+    trace_init();
+    TRACE(TR_INIT, 0, 0, 0);
+    perf_init();
     init_timer_system();    
 
     init_tarefa_principal();           //Inicializa tarefa principal (atual)
@@ -116,15 +170,16 @@ void pingpong_init (){
     userTasks = 1;
    id_count = 1;
 
-
-    #if defined(DEBUG_ALL) || defined(DEBUG_OPERATIONAL_SYSTEM)
-    printf("pingpong_init: sistema inicialzou em %u\n", systime());
-    #endif // defined(DEBUG_ALL)
 }
 
 // gerência de tarefas =========================================================
 // Cria uma nova tarefa. Retorna um ID> 0 ou erro.
 int task_create (task_t *task, void (*start_func)(void *), void *arg){
+    return task_create_flags(task, start_func, arg, 0);
+}
+
+// Cria uma nova tarefa com as flags indicadas. Retorna um ID> 0 ou erro.
+int task_create_flags (task_t *task, void (*start_func)(void *), void *arg, int flags){
 
     static int id_count = 1;
     //Checagem de erros
@@ -133,56 +188,85 @@ int task_create (task_t *task, void (*start_func)(void *), void *arg){
         return -1;
     }
 
+    preempt_disable();                   //Fila de prontas e pilhas livres são alteradas a seguir
+
     task->status = NOVO;                 //Tarefa criada, mas não inicializada
 
     //A tarefa criada não pertence a nenhuma fila (por enquanto)
     task->next = NULL;
     task->prev = NULL;
     task->fila_atual = NULL;
+    task->fila_taguardando = NULL;
+    task->ex_status = -1;
+    task->lock_p = 0;
+    task->desacoplada = (flags & TASK_DETACHED) ? 1 : 0;
 
-    getcontext (&(task->context));      //Incializa com contexto atual
-
-    char *stack = malloc (STACKSIZE);   //Inicialização da pilha
+    char *stack = stack_alloc();        //Inicialização da pilha (reaproveitada, se houver)
 
     //Inicialização do contexto da tarefa
     if (stack){
-        task->context.uc_stack.ss_sp = stack;
-        task->context.uc_stack.ss_size = STACKSIZE;
-        task->context.uc_stack.ss_flags = 0;
-        task->context.uc_link = 0;
        // task->prio_estat = STANDARD_PRIO;
         //task->prio_dinam = STANDARD_PRIO;
         task->id = ++id_count;         //Novo ID
         task->parent = tarefa_atual;    //Tarefa corrente é a criadora desta tarefa
-        task->task_dono = USUARIO;
+        task->task_dono = (task == &dispatcher) ? SISTEMA : USUARIO;  //O despachante nunca entra na fila de prontas
         //p06
         task->t_executado = 0;
         task->t_inicio = systime();
         task->contador_processo = 0;
+        task->quantum = quantum_max ? quantum_max : QUANTUM;
+        task->uso_quantum = 0;
+        task->quantum_total = 0;
+        task->rt_periodo = 0;           //Tarefa comum até task_set_deadline
+        task->rt_orcamento = 0;
+        task->rt_restante = 0;
+        task->rt_deadline = 0;
+        task->rt_esgotado = 0;
+        task->rt_perdas = 0;
+        task->acordar_em = 0;
+        task->pos_heap = -1;
+        perf_task_init(task);           //Contadores do processador (pingpong_set_perf)
+        for(int i = 0; i < TLS_SLOTS; i++){
+            task->tls[i] = NULL;        //Armazenamento local vazio (task_setspecific)
+        }
+        task->tls_extra = NULL;
+        task->cancelada = 0;
+        task->ponto_cancelamento = 0;
+        task->grupo = NULL;             //group_spawn inclui a tarefa no grupo depois de criada
+        escalonador->task_new(task);    //Campos próprios da política de escalonamento
 
         task_setprio(task, STANDARD_PRIO);    //Prioridade default
     	task_set_dinamic_prio(task, task_getprio(task));
 
     }
     else{
-        char error[32];
-        sprintf(error, "Erro na criação da pilha da tarefa %d em %ums", task->id, task->t_inicio);
+        char error[64];
+        snprintf(error, sizeof(error), "Erro na criação da pilha da tarefa %d em %ums", task->id, task->t_inicio);
         perror (error);
         exit(-1);
     }
-    userTasks++;
 
-    makecontext (&task->context, (void*)(*start_func), 1, arg);     //Associa o contexto à função passada por argumento
+    contexto_cria(task, stack, start_func, arg);     //Associa o contexto à função passada por argumento
 
     //Caso seja uma tarefa de usuário (ID > 1)
     if(task->task_dono == USUARIO){
 
         userTasks++;                //Nova tarefa de usuário criada
+        CONTA(criadas, 1);
+        stats_task_new(task);
+
+        //Cada tarefa viva cabe em qualquer heap: as inserções feitas pelo
+        //tratador do timer (task_set_ready, task_sleep) nunca chamam o malloc
+        if(heap_reserve(&cfs_heap, userTasks + 1) || heap_reserve(&edf_heap, userTasks + 1)
+           || heap_reserve(&dormindo, userTasks + 1)){
+            perror("Erro ao reservar os heaps de tarefas: ");
+            exit(-1);
+        }
 
         if(task_set_ready(task)){    //Tenta mudar seu estado para PRONTO e inserir na fila de prontos
         
-            char error[32];
-            sprintf(error, "Erro ao mudar estado da tarefa %d para PRONTA.", task->id);
+            char error[64];
+            snprintf(error, sizeof(error), "Erro ao mudar estado da tarefa %d para PRONTA.", task->id);
             perror (error);
             exit(-1);
         }
@@ -191,10 +275,11 @@ int task_create (task_t *task, void (*start_func)(void *), void *arg){
         task->status = PRONTO;       //Apenas muda o estado, caso seja tarefa principal ou despachante
     }
 
-    #if defined(DEBUG_ALL) || defined(DEBUG_TASK_CREATE) || defined(DEBUG_MINIMAL)
-    printf("task_create: criou a tarefa %d em %ums\n", task->id, task->t_inicio);
-    printf("Valor do Quantum %d\n", quantum_count);
-    #endif // defined(DEBUG_ALL)
+    if(task != &dispatcher){             //O despachante é registrado por init_dispatcher, já com id -1
+        TRACE(TR_CRIA, task->id, task->prio_estat, task->quantum);
+    }
+
+    preempt_enable();
 
     return task->id;
 }
@@ -208,6 +293,13 @@ void task_exit (int exitCode){
 
     task_t *last_task = tarefa_atual;   //Última tarefa em execução
 
+    if(last_task->task_dono == USUARIO){
+        tls_task_exit(last_task);       //Destrutores executam como código da própria tarefa
+    }
+
+    preempt_disable();                  //A tarefa não volta mais a executar: nunca será reativada
+    kernel_enter();
+
     if(last_task->id == -1){             //Caso o despachante tente sair...
         tarefa_atual = &tarefa_principal;      //... a próxima tarefa será a principal, ...
     }
@@ -217,6 +309,24 @@ void task_exit (int exitCode){
     }
     
     last_task->status = FINALIZADO;       //Tarefa atual será finalizada
+    last_task->ex_status = exitCode;
+    if(last_task->task_dono == USUARIO){
+        CONTA(encerradas, 1);
+    }
+    stats_task_exit(last_task);
+
+    //Acorda as tarefas que aguardavam o encerramento desta
+    while(last_task->fila_taguardando){
+        task_resume(last_task->fila_taguardando);
+    }
+    if(last_task->grupo){
+        grupo_task_exit(last_task);
+    }
+
+    //A pilha de uma tarefa desacoplada só pode ser liberada depois de sairmos dela
+    if(last_task->desacoplada && last_task->task_dono == USUARIO){
+        tarefa_reciclar = last_task;
+    }
 
     if(tarefa_atual->task_dono == USUARIO){
 
@@ -225,11 +335,14 @@ void task_exit (int exitCode){
     }else{
         tarefa_atual->status = EXECUTANDO;   //Próxima tarefa entrará em execução
     }
-    
 
-    #ifdef DEBUG
-    printf("task_exit: tarefa %d sendo encerrado com codigo %d\n", last_task->id, exitCode);
-    #endif // DEBUG
+    kernel_exit();
+
+    TRACE(TR_SAIDA, last_task->id, exitCode, last_task->t_executado);
+
+    if(perf_ativo){
+        perf_troca(last_task);          //Contadores completos para o relatório
+    }
 
     #if defined(DEBUG_ALL) || defined(DEBUG_TASK_EXIT) || defined(DEBUG_TASK_EXIT_STATUS) || defined(DEBUG_MINIMAL)
     #if !defined(DEBUG_SYSTEM_TASK)
@@ -237,26 +350,54 @@ void task_exit (int exitCode){
     #endif // defined(DEBUG_ALL)
         printf("Task %d exited: running time %u ms, CPU time %u ms, %lld activations\n",
             last_task->id, systime()-last_task->t_inicio, last_task->t_executado, last_task->contador_processo);
+    if(last_task->task_dono == USUARIO && quantum_min && last_task->contador_processo)
+        printf("Task %d quantum: last %d ticks, average %lld ticks\n",
+            last_task->id, last_task->quantum, last_task->quantum_total / last_task->contador_processo);
+    if(last_task->rt_periodo)
+        printf("Task %d deadlines: period %u ms, budget %u ms, %u deadline misses\n",
+            last_task->id, last_task->rt_periodo, last_task->rt_orcamento, last_task->rt_perdas);
+    if(last_task->task_dono == USUARIO && perf_ativo)
+        printf("Task %d counters: %llu cycles, %llu instructions, %llu cache misses, %llu branch misses\n",
+            last_task->id, last_task->perf[0], last_task->perf[1], last_task->perf[2], last_task->perf[3]);
     #endif
 
     //Efetua a troca de contexto da a última tarefa e a tarefa principal
-    swapcontext(&last_task->context, &tarefa_atual->context);
+    contexto_troca(last_task, tarefa_atual);
 }
 
 // alterna a execução para a tarefa indicada
 int task_switch (task_t *task){
+    #if PP_VERIFICACOES
     //Checagem de erros
     if(!task){
         perror ("Tarefa não alocada corretamente: ");
         return -1;
     }
+    #endif
+
+    preempt_disable();                  //Filas e estados são alterados até a troca de contexto
+    kernel_enter();
 
     task_t *last_task = tarefa_atual;   //Última tarefa executada
     tarefa_atual = task;                //Troca da tarefa antiga para a atual
 
+    CONTA(trocas, 1);
+    if(preempcao_tick){
+        CONTA(preempcoes, 1);
+    }
+    if(perf_ativo){
+        perf_troca(last_task);          //Eventos do processador até aqui são da tarefa que sai
+    }
+
     if(last_task->task_dono == USUARIO) //Caso seje uma tarefa de usuário...
     {
-        task_set_ready(last_task); //Insere a tarefa corrente na fila de prontas, mudando seu estado para PRONTO, ...
+        escalonador->stop(last_task, preempcao_tick);   //Informa ao escalonador como a tarefa deixou o processador
+        if(quantum_min){
+            task_adapt_quantum(last_task, preempcao_tick);
+        }
+        if(last_task->status == EXECUTANDO){  //... que não foi suspensa ou encerrada, ...
+            task_set_ready(last_task); //... insere a tarefa corrente na fila de prontas, mudando seu estado para PRONTO, ...
+        }
         task_set_executing(tarefa_atual);
     }
     else{
@@ -272,17 +413,21 @@ int task_switch (task_t *task){
  //       tarefa_atual->status = EXECUTANDO;   //Caso contrário, apenas muda seu estado para PRONTO
   //  }
 
-    quantum_count = QUANTUM;
+    preempcao_tick = 0;
+    need_resched = 0;
+    quantum_count = task_quantum(tarefa_atual);
+    tarefa_atual->quantum_total += quantum_count;
 
-    #if defined(DEBUG_ALL) || defined(DEBUG_TASK_SWITCH) || defined(DEBUG_MINIMAL)
-    printf("task_switch: trocando contexto %d -> %d (tarefa criada em %ums executada %lld vezes)\n",
-        last_task->id, tarefa_atual->id, tarefa_atual->t_inicio, tarefa_atual->contador_processo);
-    #endif // defined(DEBUG_ALL)
+    TRACE(TR_TROCA, last_task->id, tarefa_atual->id, tarefa_atual->contador_processo);
 
     tarefa_atual->contador_processo++;
 
+    kernel_exit();
+
     //Troca o contexto entre as tarefas passadas como parâmetro
-    swapcontext(&last_task->context, &tarefa_atual->context);
+    contexto_troca(last_task, tarefa_atual);
+
+    preempt_enable();                   //De volta à tarefa que chamou task_switch
 
     return 0;
 }
@@ -297,6 +442,8 @@ int task_id (){
 void task_suspend (task_t *task, task_t **queue){
     task_t * working_task;
 
+    preempt_disable();
+
     if(task){                            //Caso passado uma tarefa como parâmetro...
         working_task = task;            //... se trabalhará com ela, ...
     }
@@ -304,56 +451,55 @@ void task_suspend (task_t *task, task_t **queue){
         working_task = tarefa_atual;    //... caso contrário, utilize a tarefa em execução.
     }
 
+    kernel_enter();
+
     working_task->status = SUSPENSO;   //Suspende a tarefa em trabalho
 
     if(queue){ //Se for passado uma fila como parâmetro...
     
-        if(working_task->fila_atual){ //... verifique se a tarefa está conida em alguma fila, ...
-            queue_remove(working_task->fila_atual, (queue_t *) working_task); //... se estiver, remova-a da fila atual e, ...
-        }
+        task_queue_leave(working_task); //... retire a tarefa da fila em que está contida (se houver) e, ...
         queue_append((queue_t **) queue,(queue_t *) working_task);  //... em seguida, adicione à fila passado por parâmetro, ...
         working_task->fila_atual = (queue_t **) queue;    //... atualizando para a nova fila em que se encontra.
     }
 
-    #if defined(DEBUG_ALL) || defined(DEBUG_TASK_SUSPEND) || defined(DEBUG_MINIMAL)
-        printf("task_suspend: tarefa %d entrando em suspensão.\n", working_task->id);
-    #endif  //defined(DEBUG_ALL)
+    kernel_exit();
+
+    TRACE(TR_SUSPENDE, working_task->id, 0, 0);
 
 
     //Volta para o despachante, caso a tarefa seja a corrente
     if(!task){
         task_switch(&dispatcher);
     }
-        
+
+    preempt_enable();
 }
 
 // acorda uma tarefa, retirando-a de sua fila atual, adicionando-a à fila de
 // tarefas prontas ("ready queue") e mudando seu estado para "pronta"
 void task_resume (task_t *task){
-    
+
+    preempt_disable();
     task_set_ready(task);
+    preempt_enable();
 
-    #if defined(DEBUG_ALL) || defined(DEBUG_TASK_SUSPEND) || defined(DEBUG_MINIMAL)
-    printf("task_resume: tarefa %d preparada para execução\n", task->id);
-    #endif  //defined(DEBUG_ALL)
+    TRACE(TR_RETOMA, task->id, 0, 0);
 }
 
 // operações de escalonamento ==================================================
 
 // libera o processador para a próxima tarefa, retornando à fila de tarefas
 // prontas ("ready queue")
-void task_yield (){
+int task_yield (){
     
-    #if defined(DEBUG_ALL) || defined(DEBUG_TASK_SWITCH) || defined(DEBUG_MINIMAL)
-    printf("task_yield: liberando-se da tarefa %d\n", tarefa_atual->id);
-    #endif  //defined(DEBUG_ALL)
+    TRACE(TR_CEDE, tarefa_atual->id, 0, 0);
 
     /*Tarefa de usuário é sempre maior que 1
     if(tarefa_atual->id > 1) { //Caso seje uma tarefa de usuário...
    
         if(task_set_ready(tarefa_atual)){ //Insere a tarefa corrente na fila de prontas, mudando seu estado para PRONTO, ...        
-            char error[32];
-            sprintf(error, "Erro ao mudar estado da tarefa %d para PRONTA.", tarefa_atual->id);
+            char error[64];
+            snprintf(error, sizeof(error), "Erro ao mudar estado da tarefa %d para PRONTA.", tarefa_atual->id);
             perror (error);
             exit(-1);
         }
@@ -362,48 +508,67 @@ void task_yield (){
              tarefa_atual->status = PRONTO;   //Caso contrário, apenas muda seu estado para PRONTO
     }  
 */
+    if(tarefa_atual->rt_periodo){       //Tarefa de tempo real: o trabalho deste período terminou
+        tarefa_atual->rt_restante = 0;
+    }
+
+    #if PP_ESTATISTICAS
+    kernel_enter();                     //O tick não pode trocar de tarefa no meio do incremento
+    CONTA(cessoes, 1);
+    kernel_exit();
+    #endif
+
     //Retorna para o despachante
     task_switch(&dispatcher);
-}
 
-//Mostra o ID de uma tarefa na tela (para debug)
-#if defined(DEBUG_ALL) || defined(DEBUG_DISPATCHER) || defined(DEBUG_OPERATIONAL_SISTEM)
-    void task_print(void* task_v){
-        task_t *task = (task_t *) task_v;
-        printf("<%d>", task->id);
-    }
-#endif //defined(DEBUG_ALL)
+    //Ponto de cancelamento: a troca acontece mesmo assim, para que laços do
+    //núcleo que cedem o processador à espera de outra tarefa progridam
+    return tarefa_atual->cancelada ? TASK_CANCELED : 0;
+}
 
 //Corpo de função da tarefa despachante
 void dispatcher_body(void *arg){
-    
+
+    (void) arg;
     dispatcher.status = EXECUTANDO;  //Despachante em execução
     
     while(userTasks) {           //Enquanto houver tarefas de usuários
-    
+
+        //Mede o custo do despachante (estatísticas e quantum adaptativo)
+        long long inicio = (PP_ESTATISTICAS || quantum_min) ? relogio_ns() : 0;
+
+        task_wake_sleepers();
+        if(io_esperando && io_ultimo_poll != systime()){  //No máximo uma consulta ao epoll por tick
+            io_poll(0);
+        }
+        if(aio_pendentes){          //Submete e colhe a E/S de arquivos assíncrona
+            aio_dispatch();
+        }
+
         task_t* next = scheduler(); //Próxima tarefa dada pelo escalonador
 
         if(next){
-            
-              #if defined(DEBUG_ALL) || defined(DEBUG_DISPATCHER) || defined(DEBUG_OPERATIONAL_SISTEM) || defined(DEBUG_MINIMAL)
-                printf("dispatcher_body: tarefa %d a ser executada\n", next->id);
-            #endif // defined(DEBUG_ALL)
-            #if defined(DEBUG_ALL) || defined(DEBUG_DISPATCHER) || defined(DEBUG_OPERATIONAL_SISTEM)
-                queue_print("Tarefas",(queue_t *)fila_tprontas, task_print);
-            #endif //defined(DEBUG_ALL)
 
             if(task_set_executing(next)){    //Muda estado da próxima tarefa para EXECUTANDO e retira-a da fila atual
             
-                char error[32];
-                sprintf(error, "Erro ao mudar estado da tarefa %d para EXECUTANDO.", next->id);
+                char error[64];
+                snprintf(error, sizeof(error), "Erro ao mudar estado da tarefa %d para EXECUTANDO.", next->id);
                 perror(error);
                 exit(-1);
             }
             task_set_ready(&dispatcher);
             task_set_executing(next);
-            task_switch(next);              //Executa a próxima tarefa            
+            if(PP_ESTATISTICAS || quantum_min){
+                long long custo = relogio_ns() - inicio;
+                CONTA(despachante_ns, custo);
+                if(quantum_min){
+                    custo_troca_ns += (custo - custo_troca_ns) / 8;
+                }
+            }
+            task_switch(next);              //Executa a próxima tarefa
+            task_reclaim_pending();         //Libera a pilha de uma tarefa desacoplada que acabou de sair
         }
-        else if (!fila_tprontas){
+        else if (!dispatcher_idle()){    //Nenhuma tarefa pronta: espera sem consumir processador
             break;
         }
     }
@@ -415,26 +580,19 @@ void dispatcher_body(void *arg){
 //Função do escalonador
 task_t *scheduler(){
     
+    task_t *next = edf_pick();              //Tarefas de tempo real têm precedência sobre as demais
+
     //Se a fila de tarefas prontas estiver vazia, retorne nulo
-    if(!fila_tprontas){
+    if(!next && !n_prontas){
         return NULL;
     }
 
-    
-    
-    //FCFS- ṕrimeiro elemento da fila será o próximo a executar
-    task_t *next = prioridade_max(&fila_tprontas, task_compare);
-
-    task_get_old(next);
-	task_set_dinamic_prio(next, task_getprio(next));
-    //Prepara a próxima tarefa para a próxima execução
-    //fila_tprontas = fila_tprontas->next;
+    if(!next){
+        next = escalonador->pick();         //A política em uso escolhe a próxima tarefa
+    }
 
+    TRACE(TR_ESCOLHE, next->id, n_prontas, 0);
 
-    #if defined(DEBUG_ALL) || defined(DEBUG_TASK_PRIORITIES) || defined(DEBUG_DISPATCHER) || defined(DEBUG_OPERATIONAL_SISTEM)
-        printf("scheduler: tarefa %d selecionada\n", next->id);
-    #endif //defined(DEBUG_ALL)
-    
     return next;
 }
 
@@ -454,6 +612,7 @@ void init_tarefa_principal(){
     tarefa_principal.t_inicio = 0;
     tarefa_principal.t_executado = 0;
     tarefa_principal.contador_processo = 1;
+    tarefa_principal.quantum = quantum_max ? quantum_max : QUANTUM;
 
     tarefa_principal.ex_status = -1;
     tarefa_principal.lock_p = 0;
@@ -461,21 +620,15 @@ void init_tarefa_principal(){
     task_setprio(&tarefa_principal, STANDARD_PRIO);    //Prioridade default
     task_set_dinamic_prio(&tarefa_principal, task_getprio(&tarefa_principal));
 
-    userTasks++;
+    escalonador->task_new(&tarefa_principal);  //Campos próprios da política de escalonamento
 
-    if(task_set_ready(&tarefa_principal)){  //Tenta mudar seu estado para PRONTO e inserir na fila de prontos
-    
-        char error[32];
-        sprintf(error, "Erro ao mudar estado da tarefa principal para PRONTA.");
-        perror (error);
-        exit(-1);
-    }
+    userTasks++;
+    stats_task_new(&tarefa_principal);
 
+    //A tarefa principal já está executando, portanto não entra na fila de prontas
     tarefa_atual = &tarefa_principal;      //... e é a tarefa em execução no momento.
 
-    #ifdef DEBUG
-    printf("init_main_task: tarefa principal iniciada com id %d", tarefa_principal.id);
-    #endif  //DEBUG
+    TRACE(TR_CRIA, tarefa_principal.id, tarefa_principal.prio_estat, tarefa_principal.quantum);
 
 }
 void init_dispatcher(){
@@ -484,6 +637,8 @@ void init_dispatcher(){
     dispatcher.status = PRONTO;
     dispatcher.task_dono = SISTEMA;
     dispatcher.id = -1;
+
+    TRACE(TR_CRIA, dispatcher.id, dispatcher.prio_estat, dispatcher.quantum);
 }
 
 //Função interna para ajudar a mudar o estado de uma tarefa e inseri-la na fila de prontas
@@ -496,12 +651,25 @@ int task_set_ready(task_t* task){
             return 0;
         }
 
-        if(task->fila_atual){     //Se estiver inserido em uma fila, ...
-            queue_remove(task->fila_atual, (queue_t *) task);   //... remove-lo desta fila e...
+        kernel_enter();
+        task_queue_leave(task);   //Se estiver inserido em uma fila, remove-lo desta fila e...
+
+        if(task->rt_periodo && !task->rt_restante){   //Tempo real sem orçamento aguarda o próximo período
+            edf_throttle(task);
+            kernel_exit();
+            return 0;
         }
-        
-        queue_append((queue_t **) &fila_tprontas, (queue_t *) task);     //... inseri-lo na fila de prontos, ...
-        task->fila_atual = (queue_t **) &fila_tprontas;    //... atualizando sua nova fila em seguida.
+
+        if(task->rt_periodo){
+            edf_enqueue(task);          //... inseri-lo no heap de deadlines, ...
+        }
+        else{
+            escalonador->enqueue(task);     //... ou na fila de prontos, ...
+        }
+        task->fila_atual = FILA_PRONTAS;    //... atualizando sua nova fila em seguida.
+        n_prontas++;
+        stats_pronta(task);
+        kernel_exit();
 
         return 0;
 }
@@ -516,11 +684,110 @@ int task_set_executing(task_t* task){
             return 0;
         }
 
-        if(task->fila_atual) { //Se estiver inserido em uma fila, ...       
-            queue_remove(task->fila_atual, (queue_t *) task);   //... remove-lo desta fila e...
-            task->fila_atual = NULL; //... atualizar para fila nula em seguida.
+        stats_executa(task);     //Quanto esperou na fila de prontas
+
+        kernel_enter();
+        task_queue_leave(task);  //Se estiver inserido em uma fila, remove-lo desta fila
+        kernel_exit();
+
+        return 0;
+}
+
+//Retira uma tarefa da fila em que se encontra: a fila de prontas pertence ao
+//escalonador, as demais são filas comuns
+void task_queue_leave(task_t* task){
+
+        if(!task->fila_atual){
+            return;
         }
 
+        kernel_enter();
+        if(task->fila_atual == FILA_DORMINDO){
+            heap_remove(&dormindo, task);
+        }
+        else if(task->fila_atual == FILA_PRONTAS){
+            if(task->rt_periodo){
+                edf_remove(task);
+            }
+            else{
+                escalonador->remove(task);
+            }
+            n_prontas--;
+        }
+        else{
+            queue_unlink(task->fila_atual, (queue_t *) task);  //fila_atual é sempre a fila da tarefa: O(1), sem busca
+        }
+        task->fila_atual = NULL;
+        kernel_exit();
+}
+
+//Ativa o quantum adaptativo entre min e max ticks (min 0 desativa)
+int pingpong_set_quantum (int min, int max){
+
+        if(min < 0 || (min && max < min)){
+            return -1;
+        }
+        quantum_min = min;
+        quantum_max = min ? max : 0;
+        return 0;
+}
+
+//Quantum do próximo turno: tarefas de tempo real e o modo fixo usam o da política
+int task_quantum(task_t *task){
+
+        if(!quantum_min || task->task_dono == SISTEMA || task->rt_periodo){
+            return escalonador->quantum(task);
+        }
+        return task->quantum;
+}
+
+//Recalcula o quantum adaptativo de uma tarefa que deixou o processador: quem
+//esgota o quantum (CPU-bound) recebe mais, quem bloqueia ou cede recebe menos,
+//e a fila de prontas curta reduz o quantum para manter a latência baixa
+void task_adapt_quantum(task_t *task, int preemptada){
+
+        //Passo arredondado para longe de zero: a média chega a 0 e a 100 (truncado,
+        //pararia a 3 do alvo e o quantum nunca chegaria ao máximo nem ao piso)
+        int passo = (preemptada ? 100 : 0) - task->uso_quantum;
+        task->uso_quantum += (passo + (passo > 0 ? 3 : -3)) / 4;
+
+        //Piso: o custo de uma troca não deve passar de 1/ADAPT_CUSTO do quantum
+        long tick_ns = (TICK_SEG * 1000000L + TICK_MSEG) * 1000L;
+        int piso = (int) ((custo_troca_ns * ADAPT_CUSTO + tick_ns - 1) / tick_ns);
+        if(piso < quantum_min){
+            piso = quantum_min;
+        }
+        if(piso > quantum_max){
+            piso = quantum_max;
+        }
+
+        int fila = n_prontas + 1;
+        if(fila > ADAPT_FILA){
+            fila = ADAPT_FILA;
+        }
+
+        task->quantum = piso + (quantum_max - piso) * task->uso_quantum / 100 * fila / ADAPT_FILA;
+}
+
+//Relógio monotônico em nanossegundos
+long long relogio_ns(){
+
+        #ifdef PP_RELOGIO_VIRTUAL           //Medidas do núcleo também no tempo virtual: execuções idênticas
+        return (long long) sys_clock_ms * 1000000LL;
+        #else
+        struct timespec ts;
+        clock_gettime(CLOCK_MONOTONIC, &ts);
+        return (long long) ts.tv_sec * 1000000000LL + ts.tv_nsec;
+        #endif
+}
+
+//Define a política de escalonamento; só pode ser trocada antes de pingpong_init
+int pingpong_set_scheduler (sched_policy_t *policy){
+
+        if(!policy || tarefa_atual){
+            return -1;
+        }
+        escalonador = policy;
         return 0;
 }
 
@@ -726,6 +993,63 @@ task_t* prioridade_max(task_t** task_q, int task_comp(task_t*,task_t*)){
     return max_prio;
 }
 
+//Política padrão: prioridades dinâmicas com envelhecimento ===================
+void prio_task_new(task_t *task){
+    (void) task;            //As prioridades são iniciadas por task_setprio em task_create
+}
+
+void prio_enqueue(task_t *task){
+    queue_append((queue_t **) &fila_tprontas, (queue_t *) task);
+}
+
+void prio_remove(task_t *task){
+    queue_remove((queue_t **) &fila_tprontas, (queue_t *) task);
+}
+
+//A tarefa de maior prioridade dinâmica é escolhida e as demais envelhecem
+task_t *prio_pick(){
+    task_t *next = prioridade_max(&fila_tprontas, task_compare);
+
+    task_get_old(next);
+    task_set_dinamic_prio(next, task_getprio(next));
+
+    return next;
+}
+
+void prio_stop(task_t *task, int preemptada){
+    (void) task;
+    (void) preemptada;
+}
+
+int prio_quantum(task_t *task){
+    (void) task;
+    return QUANTUM;
+}
+
+sched_policy_t sched_prio = {
+    "prio", prio_task_new, prio_enqueue, prio_remove, prio_pick, prio_stop, prio_quantum
+};
+
+//Desativa a preempção por tempo da tarefa corrente (aninhável)
+void preempt_disable (){
+    if(tarefa_atual){
+        tarefa_atual->lock_p++;
+        __atomic_signal_fence(__ATOMIC_SEQ_CST);   //A seção crítica não é reordenada para antes do incremento
+    }
+}
+
+//Reativa a preempção; a troca pedida pelo timer durante a seção crítica acontece agora
+void preempt_enable (){
+    if(!tarefa_atual){
+        return;
+    }
+    __atomic_signal_fence(__ATOMIC_SEQ_CST);       //Nem para depois do decremento
+    if(!--tarefa_atual->lock_p && need_resched && tarefa_atual->task_dono == USUARIO){
+        preempcao_tick = 1;
+        task_switch(&dispatcher);
+    }
+}
+
 //p05===============================================================
 //Inicializa o temporizador do sistema
 void init_timer_system(){
@@ -745,38 +1069,93 @@ void init_timer_system(){
     timer.it_interval.tv_usec = TICK_MSEG;   // disparos subsequentes, em micro-segundos
     timer.it_interval.tv_sec  = TICK_SEG;   // disparos subsequentes, em segundos
 
+    #ifndef PP_RELOGIO_VIRTUAL           //Relógio virtual: os ticks vêm só de pp_advance
     if (setitimer (ITIMER_REAL, &timer, 0) < 0) //temprizador pelo tempo real
     {
         perror ("Erro em setitimer: ") ;
         exit (1) ;
     }
-    #ifdef DEBUG
-    printf("init_timer: temporizador iniciado com %d segundos mais %d microssegundos\n", TICK_SEG, TICK_MSEG);
-    #endif  //DEBUG
+    #endif
 }
 
 // tratador do signal, manipula interupção a cada tick
 void timer_tick(int signum){
 
-    sys_clock_ms++;
-    tarefa_atual->t_executado++;
+    (void) signum;
 
+    sys_clock_ms += PP_TICK_MS;
+    if(!tarefa_atual){              //O sistema ainda está sendo inicializado
+        return;
+    }
+    tarefa_atual->t_executado += PP_TICK_MS;
+
+    if(em_nucleo){                  //Filas e estados em alteração: o tick é processado em kernel_exit
+        tick_pendente++;
+        return;
+    }
+
+    TRACE(TR_TICK, tarefa_atual->id, quantum_count, tarefa_atual->t_executado);
+
+    if(tick_account() || need_resched){
+        sig_atomic_t tratador = em_tratador;
+        em_tratador = 1;            //Trocas feitas daqui saem com o SIGALRM bloqueado
+        tick_preempt();
+        em_tratador = tratador;
+    }
+}
+
+//Contabiliza um tick na tarefa atual (quantum e orçamento de tempo real);
+//retorna 1 se ela deve deixar o processador
+int tick_account(){
+
+    int trocar = 0;
 
-    #if defined(DEBUG_ALL) || defined(DEBUG_OPERATIONAL_SYSTEM)
-    printf("timer_tick: alarme %d tick %d de %d em %ums\n", signum, QUANTUM - quantum_count, QUANTUM, systime());
-    printf("timer_tick: tarefa %d com %ums de processamento \n", tarefa_atual->id, tarefa_atual->t_executado);
-    #endif  //defined(DEBUG_ALL)
-        
     if(tarefa_atual->task_dono == USUARIO){
-    
-        if(!quantum_count--){
+
+        //Orçamento da tarefa de tempo real esgotado, ou uma tarefa de tempo real foi liberada
+        if((tarefa_atual->rt_periodo && edf_tick(tarefa_atual))
+            || (edf_espera && systime() >= edf_liberacao)){
+            trocar = 1;
+        }
+        else if(!quantum_count--){
             #ifdef DEBUG
             printf("timer_tick: fim do quantum de %d, trocando para dispatcher\n", tarefa_atual->id);
            // printf("Tamanho do Quantum %d \n", quantum_count);
             #endif  //DEBUG
-            task_switch(&dispatcher);
+            trocar = 1;
         }
     }
+    return trocar;
+}
+
+//Troca para o despachante, ou adia a troca se a preempção estiver desativada
+void tick_preempt(){
+
+    if(tarefa_atual->lock_p || tarefa_atual->task_dono != USUARIO){
+        need_resched = 1;           //Seção crítica: a troca fica para preempt_enable (ou o próximo tick)
+    }
+    else{
+        preempcao_tick = 1;
+        task_switch(&dispatcher);
+    }
+}
+
+//Processa os ticks que chegaram dentro do núcleo. A troca de contexto não é
+//feita aqui (a saída do núcleo pode estar no meio de task_switch): fica
+//pedida em need_resched para o próximo preempt_enable ou tick
+void kernel_replay(){
+
+    em_nucleo++;
+    while(tick_pendente){
+        sig_atomic_t n = tick_pendente;
+        tick_pendente = 0;
+        while(n--){
+            if(tick_account()){
+                need_resched = 1;
+            }
+        }
+    }
+    em_nucleo--;
 }
 //p06=========================================================================
 // retorna o relógio atual (em milisegundos)
@@ -784,26 +1163,277 @@ void timer_tick(int signum){
     return sys_clock_ms;
 }
 
+//Avança o relógio virtual em ticks, como se o temporizador disparasse; a
+//tarefa corrente pode ser preemptada aqui. Sem relógio virtual, nada faz
+void pp_advance (int ticks){
+    #ifdef PP_RELOGIO_VIRTUAL
+    while(ticks-- > 0){
+        timer_tick(SIGALRM);
+    }
+    #else
+    (void) ticks;
+    #endif
+}
+
+//p09=========================================================================
+// suspende a tarefa corrente por t segundos
+int task_sleep (int t){
+
+    if(tarefa_atual->cancelada){       //Ponto de cancelamento
+        return TASK_CANCELED;
+    }
+
+    preempt_disable();
+    kernel_enter();
+
+    tarefa_atual->acordar_em = systime() + (sys_clock_t) t * 1000;
+    tarefa_atual->status = SUSPENSO;
+    task_queue_leave(tarefa_atual);
+    if(heap_insert(&dormindo, tarefa_atual)){
+        perror("Erro ao aumentar o heap de tarefas adormecidas: ");
+        exit(-1);
+    }
+    tarefa_atual->fila_atual = FILA_DORMINDO;
+    tarefa_atual->ponto_cancelamento = 1;
+
+    kernel_exit();
+
+    TRACE(TR_DORME, tarefa_atual->id, tarefa_atual->acordar_em, 0);
+
+    task_switch(&dispatcher);
+    tarefa_atual->ponto_cancelamento = 0;
+    preempt_enable();
+
+    return tarefa_atual->cancelada ? TASK_CANCELED : 0;     //Acordada antes do prazo pelo cancelamento
+}
+
+//Acorda as tarefas adormecidas cujo prazo venceu
+void task_wake_sleepers(){
+
+    task_t *task = heap_top(&dormindo);
+
+    while(task && task->acordar_em <= systime()){
+        task_set_ready(task);          //Sai do heap de adormecidas
+        task = heap_top(&dormindo);
+    }
+}
+
+//Sem tarefas prontas: em vez de girar no laço do despachante, bloqueia o
+//processo até o próximo prazo (tarefa adormecida ou período de tempo real)
+//ou, havendo tarefas esperando E/S, até um descritor ficar pronto; o relógio
+//é corrigido pelo tempo real decorrido. Retorna 0 se nenhuma tarefa puder
+//mais acordar.
+int dispatcher_idle(){
+
+    sys_clock_t prazo = NUNCA;
+    task_t *task = heap_top(&dormindo);
+
+    if(task){
+        prazo = task->acordar_em;
+    }
+    if(edf_espera && edf_liberacao < prazo){
+        prazo = edf_liberacao;
+    }
+    if(prazo == NUNCA && !io_esperando){
+        return 0;                       //Todas as tarefas restantes estão bloqueadas para sempre
+    }
+
+    TRACE(TR_OCIOSO, -1, prazo == NUNCA ? 0 : prazo, 0);
+
+    #ifdef PP_RELOGIO_VIRTUAL
+    //Sem tempo real a esperar: só a E/S bloqueia; o relógio salta para o prazo
+    if(io_esperando){
+        io_poll(prazo == NUNCA ? -1 : 0);
+    }
+    if(prazo != NUNCA && prazo > sys_clock_ms){
+        sys_clock_ms = prazo;
+    }
+    return 1;
+    #else
+
+    sigset_t alarme, anterior;
+    sigemptyset(&alarme);
+    sigaddset(&alarme, SIGALRM);
+    sigprocmask(SIG_BLOCK, &alarme, &anterior);    //Nenhum tick entre a decisão e o sigsuspend
+
+    sys_clock_t agora = systime();          //Em ms, qualquer que seja o tick (PP_TICK_MS)
+    long long inicio = relogio_ns();
+
+    if(io_esperando){
+        //Com o SIGALRM bloqueado, o epoll espera pelo descritor ou pelo prazo
+        int espera_ms = -1;
+        if(prazo != NUNCA){
+            espera_ms = prazo > agora ? (int) (prazo - agora) : 0;
+        }
+        io_poll(espera_ms);
+    }
+    else if(prazo > agora + PP_TICK_MS){
+        struct itimerval unico = { { 0, 0 }, { 0, 0 } };
+        long long espera_us = (long long) (prazo - agora) * 1000;
+
+        unico.it_value.tv_sec = espera_us / 1000000;
+        unico.it_value.tv_usec = espera_us % 1000000;
+        setitimer(ITIMER_REAL, &unico, 0);          //Um único disparo no prazo
+
+        sigset_t espera = anterior;
+        sigdelset(&espera, SIGALRM);
+        sigsuspend(&espera);
+
+        setitimer(ITIMER_REAL, &timer, 0);          //Religa o tick periódico
+    }
+    else if(prazo > agora){
+        sigset_t espera = anterior;
+        sigdelset(&espera, SIGALRM);
+        sigsuspend(&espera);                        //Prazo dentro de um tick: dorme até o próximo tick
+    }
+
+    //Corrige o relógio pelo tempo real dormido
+    long long dormido = relogio_ns() - inicio;
+    CONTA(ocioso_ns, dormido);
+    sys_clock_t decorrido = (sys_clock_t) (dormido / 1000000);
+    if(agora + decorrido > sys_clock_ms){
+        sys_clock_ms = agora + decorrido;
+    }
+
+    sigprocmask(SIG_SETMASK, &anterior, 0);
+    return 1;
+    #endif
+}
+
 //Suspende a tarefa corrente e insere-a na fila de tarefas esperando conclusão de task (joinned)
 int task_join (task_t *task)
 {
-    tarefa_atual->lock_p = 1;   //Evita condicoes de disputa entre desta tarefa e o controle de preempcao
     if(!task){                       //Se não for passado uma tarefa como parametro, retorne imediatamente
         return -1;
     }
+    preempt_disable();   //Evita condicoes de disputa entre desta tarefa e o controle de preempcao
     if(task->status == FINALIZADO){    //Se a tarefa passada como parâmetro houver finalizado, retorne imediatamente
+        task_release(task);            //Encerrou antes do join: a pilha ainda não foi reciclada
+        preempt_enable();
+        return task->ex_status;
+    }
+    if(task->desacoplada){             //Ninguém pode aguardar uma tarefa desacoplada
+        preempt_enable();
         return -1;
     }
 
-    #if defined(DEBUG_ALL) || defined(DEBUG_TASK_SUSPEND) || defined(DEBUG_MINIMAL)
-    printf("task_join: tarefa %d se juntando à %d\n", tarefa_atual->id, task->id);
-    #endif  //defined(DEBUG_ALL)
+    if(tarefa_atual->cancelada){       //Ponto de cancelamento
+        preempt_enable();
+        return TASK_CANCELED;
+    }
+
+    TRACE(TR_JOIN, tarefa_atual->id, task->id, 0);
 
+    tarefa_atual->ponto_cancelamento = 1;
     task_suspend(NULL, &task->fila_taguardando);   //Suspendendo tarefa e inserindo-a na fila
-    tarefa_atual->lock_p = 0;      //Reabilita controle de preempcao
-    #if defined(DEBUG_ALL) || defined(DEBUG_TASK_SUSPEND) || defined(DEBUG_MINIMAL)
-    printf("task_join: tarefa %d retornou de %d com código de saida %d\n", tarefa_atual>id, task->tid, task->ex_status);
-    #endif  //defined(DEBUG_ALL)
+    tarefa_atual->ponto_cancelamento = 0;
+    if(task->status != FINALIZADO){    //Acordada pelo cancelamento, não pelo encerramento
+        preempt_enable();
+        return TASK_CANCELED;
+    }
+    TRACE(TR_JOIN_FIM, tarefa_atual->id, task->id, task->ex_status);
+
+    task_release(task);            //A tarefa aguardada já encerrou, sua pilha pode ser reciclada
+    preempt_enable();              //Reabilita controle de preempcao
 
     return task->ex_status;
+}
+
+//Marca a tarefa como cancelada: os pontos de cancelamento (task_yield,
+//task_join, task_sleep, group_wait) passam a retornar TASK_CANCELED a ela, e se
+//está suspensa num deles é acordada agora; encerrar cabe à própria tarefa
+int task_cancel (task_t *task)
+{
+    if(!task || task->task_dono == SISTEMA || task->status == FINALIZADO){
+        return -1;
+    }
+
+    preempt_disable();
+
+    task->cancelada = 1;
+    if(task->ponto_cancelamento && task->status == SUSPENSO){
+        task_resume(task);              //Sai da fila em que espera e recebe TASK_CANCELED
+    }
+
+    preempt_enable();
+
+    TRACE(TR_CANCELA, task->id, tarefa_atual->id, 0);
+
+    return 0;
+}
+
+//Desacopla uma tarefa: ninguém fará join sobre ela e sua pilha é reciclada ao encerrar
+int task_detach (task_t *task)
+{
+    if(!task){                       //Para uma tarefa nula, será desacoplada a tarefa em execução
+        task = tarefa_atual;
+    }
+    if(task->task_dono == SISTEMA || task == &tarefa_principal){   //Tarefas do sistema e a principal não são recicladas
+        return -1;
+    }
+
+    preempt_disable();
+
+    task->desacoplada = 1;
+
+    if(task->status == FINALIZADO){    //Já encerrou e não está em execução: libera imediatamente
+        task_release(task);
+    }
+
+    preempt_enable();
+
+    TRACE(TR_DESACOPLA, task->id, 0, 0);
+
+    return 0;
+}
+
+//Obtém uma pilha para uma nova tarefa, reaproveitando pilhas liberadas
+char *stack_alloc()
+{
+    if(pilhas_livres){                          //Há uma pilha livre, reutilize-a
+        void **stack = (void **) pilhas_livres;
+        pilhas_livres = *stack;
+        n_pilhas_livres--;
+        return (char *) stack;
+    }
+    return malloc (STACKSIZE);
+}
+
+//Devolve uma pilha ao conjunto de pilhas livres (ou ao sistema, se o conjunto estiver cheio)
+void stack_release(char *stack)
+{
+    if(!stack){
+        return;
+    }
+    if(n_pilhas_livres >= STACK_POOL_MAX){
+        free(stack);
+        return;
+    }
+    *(void **) stack = pilhas_livres;          //O primeiro word da pilha livre aponta para a próxima
+    pilhas_livres = stack;
+    n_pilhas_livres++;
+}
+
+//Libera os recursos de uma tarefa encerrada (a tarefa não pode estar em execução)
+void task_release(task_t *task)
+{
+    if(!task || task->status != FINALIZADO){
+        return;
+    }
+    if(task->task_dono == SISTEMA || task == &tarefa_principal){   //Pilhas que não foram alocadas por task_create
+        return;
+    }
+
+    stack_release(task->context.uc_stack.ss_sp);
+    task->context.uc_stack.ss_sp = NULL;       //O descritor pode ser reutilizado por task_create
+    task->context.uc_stack.ss_size = 0;
+}
+
+//Libera a tarefa desacoplada que encerrou antes da última troca de contexto
+void task_reclaim_pending()
+{
+    if(tarefa_reciclar){
+        task_release(tarefa_reciclar);
+        tarefa_reciclar = NULL;
+    }
 }
\ No newline at end of file
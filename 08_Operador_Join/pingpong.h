@@ -9,6 +9,8 @@
 
 #define _XOPEN_SOURCE 600	// para evitar erros POSIX no MacOS X
 
+#include <sys/types.h>
+#include <sys/socket.h>
 #include "datatypes.h"		// estruturas de dados necessárias
 
 // funções gerais ==============================================================
@@ -16,6 +18,20 @@
 // Inicializa o sistema operacional; deve ser chamada no inicio do main()
 void pingpong_init () ;
 
+// políticas de escalonamento disponíveis
+extern sched_policy_t sched_prio ;	// prioridades com envelhecimento (padrão)
+extern sched_policy_t sched_mlfq ;	// filas multinível com realimentação
+extern sched_policy_t sched_cfs ;	// tempo virtual ponderado (fair-share)
+
+// define a política de escalonamento; deve ser chamada antes de pingpong_init()
+int pingpong_set_scheduler (sched_policy_t *policy) ;
+
+// ativa o quantum adaptativo, entre min e max ticks: cada tarefa recebe um
+// quantum maior quanto mais esgota seus quanta e quanto maior a fila de
+// prontas, nunca menor que o necessário para amortizar o custo medido das
+// trocas de contexto; min 0 volta ao quantum da política. Retorna 0 ou -1.
+int pingpong_set_quantum (int min, int max) ;
+
 // gerência de tarefas =========================================================
 
 // Cria uma nova tarefa. Retorna um ID> 0 ou erro.
@@ -23,15 +39,41 @@ int task_create (task_t *task,			// descritor da nova tarefa
                  void (*start_func)(void *),	// funcao corpo da tarefa
                  void *arg) ;			// argumentos para a tarefa
 
+// flags de criação de tarefas (task_create_flags)
+#define TASK_DETACHED	0x01		// tarefa nasce desacoplada (ver task_detach)
+
+// Cria uma nova tarefa com as flags indicadas. Retorna um ID> 0 ou erro.
+int task_create_flags (task_t *task,		// descritor da nova tarefa
+                       void (*start_func)(void *),	// funcao corpo da tarefa
+                       void *arg,		// argumentos para a tarefa
+                       int flags) ;		// TASK_DETACHED ou 0
+
 // Termina a tarefa corrente, indicando um valor de status encerramento
 void task_exit (int exitCode) ;
 
+// pede o cancelamento de uma tarefa: a partir daí os pontos de cancelamento
+// (task_yield, task_join, task_sleep, group_wait) retornam TASK_CANCELED a
+// ela, e se está suspensa num deles é acordada na hora, saindo da fila em que
+// espera. A tarefa decide como encerrar. Retorna 0 ou -1 em erro.
+int task_cancel (task_t *task) ;
+
+// desacopla uma tarefa (ou a tarefa atual): ninguém fará task_join sobre ela
+// e sua pilha é reciclada assim que ela encerrar. Retorna 0 ou -1 em erro.
+int task_detach (task_t *task) ;
+
 // alterna a execução para a tarefa indicada
 int task_switch (task_t *task) ;
 
 // retorna o identificador da tarefa corrente (main eh 0)
 int task_id () ;
 
+// desativa a preempção por tempo da tarefa corrente (chamadas aninháveis)
+void preempt_disable () ;
+
+// reativa a preempção; se o quantum acabou durante a seção crítica, a troca
+// adiada acontece agora
+void preempt_enable () ;
+
 // suspende uma tarefa, retirando-a de sua fila atual, adicionando-a à fila
 // queue e mudando seu estado para "suspensa"; usa a tarefa atual se task==NULL
 void task_suspend (task_t *task, task_t **queue) ;
@@ -43,28 +85,174 @@ void task_resume (task_t *task) ;
 // operações de escalonamento ==================================================
 
 // libera o processador para a próxima tarefa, retornando à fila de tarefas
-// prontas ("ready queue")
-void task_yield () ;
+// prontas ("ready queue"). Ponto de cancelamento: retorna TASK_CANCELED se a
+// tarefa foi cancelada, 0 caso contrário
+int task_yield () ;
 
 // define a prioridade estática de uma tarefa (ou a tarefa atual)
 void task_setprio (task_t *task, int prio) ;
 
+// coloca a tarefa (ou a tarefa atual) na classe de tempo real, com "budget" ms
+// de processador a cada "period" ms; as tarefas de tempo real executam antes
+// das demais, pelo deadline mais próximo, e task_yield encerra o trabalho do
+// período. period 0 devolve a tarefa à classe comum. Retorna 0 ou -1 em erro.
+int task_set_deadline (task_t *task, unsigned int period, unsigned int budget) ;
+
 // retorna a prioridade estática de uma tarefa (ou a tarefa atual)
 int task_getprio (task_t *task) ;
 
+// armazenamento local das tarefas =============================================
+
+// Cria uma chave: cada tarefa tem seu próprio valor para ela, inicialmente
+// NULL. Ao encerrar, a tarefa chama destrutor(valor) para cada valor não nulo
+// (destrutor pode ser NULL). Retorna 0 ou -1 se as TLS_CHAVES já foram criadas.
+int task_key_create (task_key_t *key, void (*destrutor)(void *)) ;
+
+// valor da chave na tarefa corrente (NULL se não definido)
+void *task_getspecific (task_key_t key) ;
+
+// define o valor da chave na tarefa corrente. Retorna 0 ou -1 em erro.
+int task_setspecific (task_key_t key, const void *valor) ;
+
 // operações de sincronização ==================================================
 
-// a tarefa corrente aguarda o encerramento de outra task
+// a tarefa corrente aguarda o encerramento de outra task. Ponto de
+// cancelamento: retorna TASK_CANCELED, sem esperar, se a tarefa corrente foi
+// cancelada
 int task_join (task_t *task) ;
 
+// código dos pontos de cancelamento (task_yield, task_join, task_sleep,
+// group_wait) quando a tarefa corrente foi cancelada (task_cancel,
+// group_cancel); a tarefa deve liberar seus recursos e encerrar
+#define TASK_CANCELED	(-2)
+
+// grupos de tarefas ===========================================================
+
+// Inicializa um grupo vazio. O grupo deve existir até todas as suas tarefas
+// encerrarem (group_wait)
+void group_init (task_group_t *group) ;
+
+// Cria uma tarefa desacoplada no grupo (sua pilha é reciclada ao encerrar;
+// aguarde o grupo, não a tarefa). Retorna o ID da tarefa ou -1 em erro.
+int group_spawn (task_group_t *group, task_t *task,
+                 void (*start_func)(void *), void *arg) ;
+
+// Aguarda o encerramento de todas as tarefas do grupo; a tarefa corrente é
+// acordada uma única vez, quando a última encerra. Retorna 0, ou
+// TASK_CANCELED se a tarefa corrente foi cancelada (ponto de cancelamento)
+int group_wait (task_group_t *group) ;
+
+// Cancela as tarefas ativas do grupo e as que forem criadas nele depois: as
+// suspensas num ponto de cancelamento são acordadas e cada uma recebe
+// TASK_CANCELED no próximo ponto. Retorna quantas tarefas foram canceladas.
+int group_cancel (task_group_t *group) ;
+
 // operações de gestão do tempo ================================================
 
-// suspende a tarefa corrente por t segundos
-void task_sleep (int t) ;
+// suspende a tarefa corrente por t segundos. Ponto de cancelamento: retorna
+// TASK_CANCELED (mesmo antes do prazo) se a tarefa foi cancelada, 0 caso contrário
+int task_sleep (int t) ;
 
 // retorna o relógio atual (em milisegundos)
 unsigned int systime () ;
 
+// Compilado com -DPP_RELOGIO_VIRTUAL, o relógio não segue o tempo real: só
+// avança com pp_advance (cada tick pode preemptar a tarefa corrente, sempre
+// no mesmo ponto) e, com o sistema ocioso, salta direto para o próximo prazo.
+// Execuções repetidas escalonam exatamente da mesma forma. No modo normal
+// pp_advance não faz nada.
+void pp_advance (int ticks) ;
+
+// estatísticas =================================================================
+
+// contadores globais do núcleo (pingpong_get_stats)
+struct pp_stats
+{
+    unsigned long long trocas;          //Trocas de contexto (inclusive para o despachante)
+    unsigned long long cessoes;         //Chamadas a task_yield
+    unsigned long long preempcoes;      //Tarefas retiradas do processador pelo fim do quantum
+    unsigned long long criadas;         //Tarefas de usuário criadas
+    unsigned long long encerradas;      //Tarefas de usuário encerradas
+    unsigned int vivas;                 //Tarefas de usuário ainda não encerradas
+    unsigned int prontas;               //Tamanho da fila de prontas no momento da amostra
+    unsigned long long ocioso_ns;       //Tempo com o processo bloqueado, sem tarefas prontas
+    unsigned long long despachante_ns;  //Tempo gasto pelo despachante para escolher e preparar tarefas
+    unsigned int relogio;               //systime() no momento da amostra
+};
+
+// amostra de uma tarefa viva (pingpong_get_task_stats)
+struct pp_task_stats
+{
+    int id;
+    int status;                         //status_t da tarefa
+    int prio;                           //Prioridade estática
+    unsigned int cpu_ms;                //Tempo de processador
+    unsigned long long ativacoes;
+    int quantum;                        //Quantum (ticks) do próximo turno, adaptativo ou da política
+    int quantum_medio;                  //Média dos quanta recebidos por ativação
+    unsigned long long latencia_n;      //Amostras de espera na fila de prontas
+    long long latencia_p99_ns;          //Percentil 99 da espera na fila de prontas
+    unsigned long long ciclos;          //Contadores de desempenho (pingpong_set_perf; 0 se desligados)
+    unsigned long long instrucoes;
+    unsigned long long falhas_cache;
+    unsigned long long falhas_desvio;
+};
+
+// Copia os contadores globais; custa uma cópia de estrutura
+void pingpong_get_stats (struct pp_stats *stats) ;
+
+// Preenche até max amostras das tarefas de usuário vivas; retorna quantas
+// preencheu (menos que o total se max for pequeno)
+int pingpong_get_task_stats (struct pp_task_stats *v, int max) ;
+
+// Liga (1) ou desliga (0) os contadores de desempenho do processador por
+// tarefa (ciclos, instruções, falhas de cache e de desvio), que aparecem no
+// relatório de saída e em pingpong_get_task_stats. Retorna quantos contadores
+// abriu ou -1 se nenhum está disponível. Também ligado com PINGPONG_PERF=1
+int pingpong_set_perf (int ligado) ;
+
+// Mostra, para cada tarefa viva e cada prioridade, os percentis 50, 99 e 99,9
+// do tempo entre a tarefa ficar pronta e ser despachada
+void pingpong_stats_dump () ;
+
+// rastreamento =================================================================
+
+// Liga (1) ou desliga (0) o registro dos eventos do núcleo num anel binário
+// em memória; desligado, cada ponto de rastreamento custa um teste
+void pingpong_trace (int ligado) ;
+
+// Salva os eventos do anel em arquivo, para o decodificador tracedump.
+// Retorna 0 ou -1 em erro
+int pingpong_trace_dump (const char *arquivo) ;
+
+// operações de E/S ============================================================
+
+// Versões de read/write/accept/connect que não bloqueiam o processo: o
+// descritor passa a ser não bloqueante e, quando a operação bloquearia, só a
+// tarefa corrente é suspensa até o descritor ficar pronto. Mesmos retornos
+// das chamadas POSIX. Descritores usados aqui devem ser fechados com pp_close.
+
+ssize_t pp_read (int fd, void *buf, size_t count) ;
+ssize_t pp_write (int fd, const void *buf, size_t count) ;
+int pp_accept (int fd, struct sockaddr *addr, socklen_t *addrlen) ;
+int pp_connect (int fd, const struct sockaddr *addr, socklen_t addrlen) ;
+int pp_close (int fd) ;
+
+// E/S de arquivos assíncrona: a tarefa corrente fica suspensa enquanto a
+// operação executa no io_uring (submissões de várias tarefas vão juntas numa
+// única chamada de sistema) ou, sem io_uring, numa thread auxiliar. Mesmos
+// retornos de pread/pwrite/fsync.
+
+ssize_t pp_pread (int fd, void *buf, size_t count, off_t offset) ;
+ssize_t pp_pwrite (int fd, const void *buf, size_t count, off_t offset) ;
+int pp_fsync (int fd) ;
+
+// Executa fn(arg) numa thread auxiliar do sistema, suspendendo só a tarefa
+// corrente, para chamadas que não têm versão não bloqueante (getaddrinfo,
+// stat...). fn não pode chamar funções do PingPongOS. Retorna o retorno de
+// fn; o errno deixado por fn é repassado à tarefa.
+void *task_offload (void *(*fn)(void *), void *arg) ;
+
 // operações de IPC ============================================================
 
 // semáforos
@@ -0,0 +1,289 @@
+// PingPongOS - PingPong Operating System
+//
+// E/S de arquivos assíncrona. Com io_uring, cada pp_pread/pp_pwrite/pp_fsync
+// apenas preenche uma entrada na fila de submissão e suspende a tarefa; o
+// despachante submete todas as entradas acumuladas com um único io_uring_enter
+// e colhe as conclusões direto da memória compartilhada com o núcleo. Um
+// eventfd registrado no anel acorda o despachante ocioso (via epoll).
+// Sem io_uring (kernel antigo, seccomp ou compilado com -DPP_SEM_URING), as
+// operações vão para as threads auxiliares de pp_pool.c.
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <errno.h>
+#include <unistd.h>
+#include <sys/eventfd.h>
+
+#ifndef PP_SEM_URING
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <linux/io_uring.h>
+#endif
+
+#include "pingpong.h"
+#include "kernel.h"
+
+#define AIO_LEITURA     0           /* operações de pool_job_t.op */
+#define AIO_ESCRITA     1
+#define AIO_SYNC        2
+
+#define AIO_ENTRADAS    64          /* tamanho da fila de submissão do io_uring */
+
+task_t *aio_fila = NULL;            //Tarefas suspensas aguardando uma operação
+int aio_pendentes = 0;              //Operações submetidas e ainda não concluídas
+
+//Esvazia o eventfd de conclusões e colhe as conclusões
+void aio_aviso_pronto(int fd);
+
+#ifndef PP_SEM_URING
+
+// anel do io_uring mapeado na memória do processo
+typedef struct aio_anel_t
+{
+    int fd;
+    unsigned *sq_cabeca, *sq_cauda, *sq_mascara, *sq_vetor;
+    unsigned *cq_cabeca, *cq_cauda, *cq_mascara;
+    struct io_uring_sqe *sqes;
+    struct io_uring_cqe *cqes;
+    unsigned entradas;              //Capacidade da fila de submissão
+    unsigned a_submeter;            //Entradas preenchidas e ainda não entregues ao núcleo
+    unsigned em_voo;                //Entradas entregues ao núcleo e ainda não concluídas
+} aio_anel_t ;
+
+aio_anel_t anel;
+int aio_estado = 0;                 //0: não iniciado, 1: io_uring, -1: threads auxiliares
+
+//Cria o anel; retorna -1 se o io_uring não estiver disponível
+int aio_init_uring(){
+
+    struct io_uring_params p;
+    memset(&p, 0, sizeof(p));
+
+    int fd = syscall(__NR_io_uring_setup, AIO_ENTRADAS, &p);
+    if(fd < 0){
+        return -1;
+    }
+    //IORING_OP_READ/WRITE chegaram junto com IORING_FEAT_RW_CUR_POS
+    if(!(p.features & IORING_FEAT_SINGLE_MMAP) || !(p.features & IORING_FEAT_RW_CUR_POS)){
+        close(fd);
+        return -1;
+    }
+
+    size_t tam_sq = p.sq_off.array + p.sq_entries * sizeof(unsigned);
+    size_t tam_cq = p.cq_off.cqes + p.cq_entries * sizeof(struct io_uring_cqe);
+    size_t tam = tam_sq > tam_cq ? tam_sq : tam_cq;
+
+    char *aneis = mmap(NULL, tam, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, fd, IORING_OFF_SQ_RING);
+    if(aneis == MAP_FAILED){
+        close(fd);
+        return -1;
+    }
+    anel.sqes = mmap(NULL, p.sq_entries * sizeof(struct io_uring_sqe), PROT_READ | PROT_WRITE,
+                     MAP_SHARED | MAP_POPULATE, fd, IORING_OFF_SQES);
+    if(anel.sqes == MAP_FAILED){
+        munmap(aneis, tam);
+        close(fd);
+        return -1;
+    }
+
+    anel.fd = fd;
+    anel.sq_cabeca = (unsigned *) (aneis + p.sq_off.head);
+    anel.sq_cauda = (unsigned *) (aneis + p.sq_off.tail);
+    anel.sq_mascara = (unsigned *) (aneis + p.sq_off.ring_mask);
+    anel.sq_vetor = (unsigned *) (aneis + p.sq_off.array);
+    anel.cq_cabeca = (unsigned *) (aneis + p.cq_off.head);
+    anel.cq_cauda = (unsigned *) (aneis + p.cq_off.tail);
+    anel.cq_mascara = (unsigned *) (aneis + p.cq_off.ring_mask);
+    anel.cqes = (struct io_uring_cqe *) (aneis + p.cq_off.cqes);
+    anel.entradas = p.sq_entries;   //A fila de conclusão tem o dobro: nunca transborda
+    anel.a_submeter = 0;
+    anel.em_voo = 0;
+
+    //Conclusões sinalizam o eventfd, que acorda o despachante ocioso no epoll
+    int aviso = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+    if(aviso < 0 || syscall(__NR_io_uring_register, fd, IORING_REGISTER_EVENTFD, &aviso, 1) < 0
+       || io_watch(aviso, aio_aviso_pronto) < 0){
+        if(aviso >= 0){
+            close(aviso);
+        }
+        munmap(anel.sqes, p.sq_entries * sizeof(struct io_uring_sqe));
+        munmap(aneis, tam);
+        close(fd);                      //Fecha o anel: as operações seguem pelas threads auxiliares
+        return -1;
+    }
+    return 0;
+}
+
+//Colhe as conclusões do anel
+void aio_colhe(){
+
+    unsigned cabeca = *anel.cq_cabeca;
+    unsigned cauda = __atomic_load_n(anel.cq_cauda, __ATOMIC_ACQUIRE);
+
+    while(cabeca != cauda){
+        struct io_uring_cqe *cqe = &anel.cqes[cabeca & *anel.cq_mascara];
+        pool_job_t *job = (pool_job_t *) (uintptr_t) cqe->user_data;
+
+        if(cqe->res < 0){
+            job->resultado = -1;
+            job->erro = -cqe->res;
+        }
+        else{
+            job->resultado = cqe->res;
+        }
+        anel.em_voo--;
+        aio_done(job);
+        cabeca++;
+    }
+    __atomic_store_n(anel.cq_cabeca, cabeca, __ATOMIC_RELEASE);
+}
+
+//Entrega ao núcleo, numa única chamada, as entradas acumuladas
+void aio_submete(){
+
+    while(anel.a_submeter){
+        int n = syscall(__NR_io_uring_enter, anel.fd, anel.a_submeter, 0, 0, NULL, 0);
+        if(n < 0){
+            if(errno == EINTR){         //Interrompida por um tick
+                continue;
+            }
+            if(errno == EAGAIN || errno == EBUSY){   //Sem recursos: tenta de novo na próxima volta
+                return;
+            }
+            perror("Erro ao submeter ao io_uring: ");
+            exit(-1);
+        }
+        anel.a_submeter -= n;
+        anel.em_voo += n;
+    }
+}
+
+//Preenche uma entrada da fila de submissão com a operação do trabalho
+void aio_prepara(pool_job_t *job){
+
+    unsigned cauda = *anel.sq_cauda;
+    unsigned i = cauda & *anel.sq_mascara;
+    struct io_uring_sqe *sqe = &anel.sqes[i];
+
+    memset(sqe, 0, sizeof(*sqe));
+    sqe->opcode = job->op == AIO_LEITURA ? IORING_OP_READ :
+                  job->op == AIO_ESCRITA ? IORING_OP_WRITE : IORING_OP_FSYNC;
+    sqe->fd = job->fd;
+    sqe->addr = (uintptr_t) job->buf;
+    sqe->len = job->tam;
+    sqe->off = job->pos;
+    sqe->user_data = (uintptr_t) job;
+
+    anel.sq_vetor[i] = i;
+    __atomic_store_n(anel.sq_cauda, cauda + 1, __ATOMIC_RELEASE);
+    anel.a_submeter++;
+}
+
+#endif // PP_SEM_URING
+
+void aio_aviso_pronto(int fd){
+    uint64_t n;
+    while(read(fd, &n, sizeof(n)) > 0);
+    aio_dispatch();
+}
+
+//Executa a operação de arquivo (threads auxiliares ou na própria tarefa)
+void aio_executa(pool_job_t *job){
+
+    switch(job->op){
+        case AIO_LEITURA:
+            job->resultado = pread(job->fd, job->buf, job->tam, job->pos);
+            break;
+        case AIO_ESCRITA:
+            job->resultado = pwrite(job->fd, job->buf, job->tam, job->pos);
+            break;
+        default:
+            job->resultado = fsync(job->fd);
+    }
+    job->erro = job->resultado < 0 ? errno : 0;
+}
+
+void aio_wait(pool_job_t *job){
+
+    preempt_disable();
+    job->task = tarefa_atual;
+    aio_pendentes++;
+    io_esperando++;                     //O despachante ocioso espera no epoll pelas conclusões
+    task_suspend(NULL, &aio_fila);
+    preempt_enable();
+}
+
+void aio_done(pool_job_t *job){
+    aio_pendentes--;
+    io_esperando--;
+    task_resume(job->task);
+}
+
+void aio_dispatch(){
+
+    #ifndef PP_SEM_URING
+    if(aio_estado > 0){
+        aio_submete();
+        aio_colhe();
+    }
+    #endif
+    pool_drain();                       //task_offload usa as threads auxiliares mesmo com io_uring
+}
+
+//Executa a operação suspendendo só a tarefa corrente
+ssize_t aio_opera(int op, int fd, void *buf, size_t count, off_t offset){
+
+    pool_job_t job;
+    job.op = op;
+    job.fd = fd;
+    job.buf = buf;
+    job.tam = count;
+    job.pos = offset;
+    job.erro = 0;
+    job.executa = aio_executa;
+
+    preempt_disable();                  //Submissão e suspensão sem o despachante no meio
+
+    #ifndef PP_SEM_URING
+    if(!aio_estado){
+        aio_estado = aio_init_uring() ? -1 : 1;
+    }
+    if(aio_estado > 0){
+        while(anel.a_submeter + anel.em_voo >= anel.entradas){   //Anel cheio: cede o processador
+            preempt_enable();
+            task_yield();
+            preempt_disable();
+        }
+        aio_prepara(&job);
+        aio_wait(&job);
+    }
+    else
+    #endif
+    if(pool_submit(&job) == 0){
+        aio_wait(&job);
+    }
+    else{
+        aio_executa(&job);              //Sem threads auxiliares: bloqueia o processo
+    }
+
+    preempt_enable();
+
+    if(job.erro){
+        errno = job.erro;
+    }
+    return job.resultado;
+}
+
+ssize_t pp_pread (int fd, void *buf, size_t count, off_t offset){
+    return aio_opera(AIO_LEITURA, fd, buf, count, offset);
+}
+
+ssize_t pp_pwrite (int fd, const void *buf, size_t count, off_t offset){
+    return aio_opera(AIO_ESCRITA, fd, (void *) buf, count, offset);
+}
+
+int pp_fsync (int fd){
+    return aio_opera(AIO_SYNC, fd, NULL, 0, 0);
+}
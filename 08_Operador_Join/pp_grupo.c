@@ -0,0 +1,127 @@
+// PingPongOS - PingPong Operating System
+//
+// Grupos de tarefas. O grupo conta as tarefas ativas e as mantém numa lista
+// circular: quem aguarda o grupo fica suspenso uma única vez, até a última
+// tarefa encerrar, em vez de um task_join por tarefa. O cancelamento marca
+// cada tarefa ativa e acorda as que estão suspensas num ponto de
+// cancelamento; as demais o recebem no próximo ponto (task_yield, task_join,
+// task_sleep, group_wait).
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "pingpong.h"
+#include "kernel.h"
+
+void group_init (task_group_t *group){
+
+    group->ativas = 0;
+    group->cancelado = 0;
+    group->membros = NULL;
+    group->aguardando = NULL;
+}
+
+int group_spawn (task_group_t *group, task_t *task,
+                 void (*start_func)(void *), void *arg){
+
+    if(!group || !task){
+        return -1;
+    }
+
+    preempt_disable();                  //A tarefa não pode executar (e encerrar) antes de entrar no grupo
+
+    int id = task_create_flags(task, start_func, arg, TASK_DETACHED);
+    if(id < 0){
+        preempt_enable();
+        return -1;
+    }
+
+    kernel_enter();
+    task->grupo = group;
+    task->cancelada = group->cancelado;
+    if(group->membros){
+        task->grupo_prox = group->membros;
+        task->grupo_ant = group->membros->grupo_ant;
+        group->membros->grupo_ant->grupo_prox = task;
+        group->membros->grupo_ant = task;
+    }
+    else{
+        task->grupo_prox = task->grupo_ant = task;
+        group->membros = task;
+    }
+    group->ativas++;
+    kernel_exit();
+
+    preempt_enable();
+
+    return id;
+}
+
+int group_wait (task_group_t *group){
+
+    if(!group){
+        return -1;
+    }
+    if(tarefa_atual->cancelada){       //Ponto de cancelamento
+        return TASK_CANCELED;
+    }
+
+    preempt_disable();
+
+    if(group->ativas){
+        tarefa_atual->ponto_cancelamento = 1;
+        task_suspend(NULL, &group->aguardando);    //Acordada por grupo_task_exit da última tarefa
+        tarefa_atual->ponto_cancelamento = 0;
+    }
+
+    preempt_enable();
+
+    return (group->ativas && tarefa_atual->cancelada) ? TASK_CANCELED : 0;
+}
+
+int group_cancel (task_group_t *group){
+
+    if(!group){
+        return -1;
+    }
+
+    preempt_disable();
+
+    group->cancelado = 1;
+
+    int canceladas = 0;
+    task_t *task = group->membros;
+    for(int i = 0; i < group->ativas; i++, task = task->grupo_prox){
+        if(!task->cancelada && !task_cancel(task)){
+            canceladas++;
+        }
+    }
+
+    preempt_enable();
+
+    return canceladas;
+}
+
+void grupo_task_exit(task_t *task){
+
+    task_group_t *group = task->grupo;
+
+    if(task->grupo_prox == task){
+        group->membros = NULL;
+    }
+    else{
+        task->grupo_ant->grupo_prox = task->grupo_prox;
+        task->grupo_prox->grupo_ant = task->grupo_ant;
+        if(group->membros == task){
+            group->membros = task->grupo_prox;
+        }
+    }
+    task->grupo_prox = task->grupo_ant = NULL;
+    task->grupo = NULL;
+
+    if(!--group->ativas){
+        while(group->aguardando){       //Todas acordam juntas, uma única vez
+            task_resume(group->aguardando);
+        }
+    }
+}
@@ -0,0 +1,289 @@
+// PingPongOS - PingPong Operating System
+//
+// E/S não bloqueante integrada ao escalonador: as operações pp_* tentam a
+// chamada de sistema com o descritor em modo não bloqueante e, se ela
+// bloquearia (EAGAIN), suspendem apenas a tarefa corrente na fila de espera
+// do descritor. O despachante consulta o epoll (edge-triggered) a cada tick
+// e quando fica ocioso, acordando as tarefas dos descritores prontos.
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/epoll.h>
+
+#include "pingpong.h"
+#include "kernel.h"
+
+#define IO_EVENTOS      64          /* eventos tratados por consulta ao epoll */
+
+// estado de um descritor usado pelas operações pp_*
+typedef struct io_fd_t
+{
+    task_t *leitores;       //Tarefas esperando o descritor ficar legível
+    task_t *escritores;     //Tarefas esperando o descritor ficar gravável
+    bool preparado;         //Já está em modo não bloqueante e registrado no epoll
+    bool legivel;           //Evento de leitura recebido desde a última espera (edge-triggered)
+    bool gravavel;          //Evento de escrita recebido desde a última espera
+    void (*aviso)(int fd);  //Descritor interno do núcleo: chamada quando ficar legível
+} io_fd_t ;
+
+int io_epoll = -1;                  //Descritor do epoll (criado no primeiro uso)
+io_fd_t *io_fds = NULL;             //Estado por descritor, indexado pelo número do descritor
+int io_nfds = 0;                    //Tamanho de io_fds
+int io_esperando = 0;               //Tarefas suspensas aguardando um descritor
+sys_clock_t io_ultimo_poll = 0;     //Instante da última consulta ao epoll
+
+//Retorna o estado do descritor, preparando-o no primeiro uso: modo não
+//bloqueante e registro no epoll para leitura e escrita
+io_fd_t *io_fd(int fd){
+
+    if(fd < 0){
+        errno = EBADF;
+        return NULL;
+    }
+
+    if(io_epoll < 0){
+        io_epoll = epoll_create1(EPOLL_CLOEXEC);
+        if(io_epoll < 0){
+            return NULL;
+        }
+    }
+
+    if(fd >= io_nfds){
+        int n = io_nfds ? io_nfds : 64;
+        while(n <= fd){
+            n *= 2;
+        }
+        io_fd_t *fds = realloc(io_fds, n * sizeof(io_fd_t));
+        if(!fds){
+            errno = ENOMEM;
+            return NULL;
+        }
+        for(int i = io_nfds; i < n; i++){
+            fds[i].leitores = NULL;
+            fds[i].escritores = NULL;
+            fds[i].preparado = 0;
+            fds[i].legivel = 0;
+            fds[i].gravavel = 0;
+            fds[i].aviso = NULL;
+        }
+        io_fds = fds;
+        io_nfds = n;
+    }
+
+    io_fd_t *e = &io_fds[fd];
+    if(!e->preparado){
+        int flags = fcntl(fd, F_GETFL);
+        if(flags < 0 || fcntl(fd, F_SETFL, flags | O_NONBLOCK) < 0){
+            return NULL;
+        }
+
+        struct epoll_event ev;
+        ev.events = EPOLLIN | EPOLLOUT | EPOLLRDHUP | EPOLLET;
+        ev.data.fd = fd;
+        if(epoll_ctl(io_epoll, EPOLL_CTL_ADD, fd, &ev) < 0 && errno != EEXIST && errno != EPERM){
+            return NULL;
+        }
+        //EPERM: arquivos regulares não são suportados pelo epoll, mas nunca bloqueiam
+        e->preparado = 1;
+    }
+    return e;
+}
+
+//Suspende a tarefa corrente até o descritor ficar pronto para a operação. Um
+//tick entre a chamada que falhou com EAGAIN e esta espera pode consumir a
+//única borda no epoll; o evento fica registrado no descritor e a tarefa só
+//repete a operação, sem dormir
+void io_wait(io_fd_t *e, int escrita){
+
+    bool *pronto = escrita ? &e->gravavel : &e->legivel;
+
+    preempt_disable();
+    if(!*pronto){
+        io_esperando++;
+        task_suspend(NULL, escrita ? &e->escritores : &e->leitores);
+    }
+    *pronto = 0;
+    preempt_enable();
+}
+
+//A operação deve ser repetida depois de esperar pelo descritor?
+int io_bloqueou(){
+    return errno == EAGAIN || errno == EWOULDBLOCK;
+}
+
+//Acorda todas as tarefas de uma fila de espera de descritor
+int io_acorda(task_t **fila){
+
+    int n = 0;
+    while(*fila){
+        task_resume(*fila);
+        io_esperando--;
+        n++;
+    }
+    return n;
+}
+
+//Consulta o epoll e acorda as tarefas dos descritores prontos
+int io_poll(int timeout_ms){
+
+    struct epoll_event evs[IO_EVENTOS];
+    int acordadas = 0;
+
+    io_ultimo_poll = systime();
+    if(io_epoll < 0){
+        return 0;
+    }
+
+    int n = epoll_wait(io_epoll, evs, IO_EVENTOS, timeout_ms);
+    for(int i = 0; i < n; i++){
+        int fd = evs[i].data.fd;
+        if(fd >= io_nfds){
+            continue;
+        }
+        if(io_fds[fd].aviso){           //Descritor interno (conclusões de E/S assíncrona)
+            io_fds[fd].aviso(fd);
+            continue;
+        }
+        if(evs[i].events & (EPOLLIN | EPOLLRDHUP | EPOLLHUP | EPOLLERR)){
+            io_fds[fd].legivel = 1;
+            acordadas += io_acorda(&io_fds[fd].leitores);
+        }
+        if(evs[i].events & (EPOLLOUT | EPOLLHUP | EPOLLERR)){
+            io_fds[fd].gravavel = 1;
+            acordadas += io_acorda(&io_fds[fd].escritores);
+        }
+    }
+    return acordadas;
+}
+
+//Observa um descritor interno do núcleo: aviso é chamada pelo despachante
+//quando ele fica legível (inclusive acordando o despachante ocioso)
+int io_watch(int fd, void (*aviso)(int fd)){
+
+    io_fd_t *e = io_fd(fd);
+    if(!e){
+        return -1;
+    }
+    e->aviso = aviso;
+    return 0;
+}
+
+ssize_t pp_read (int fd, void *buf, size_t count){
+
+    io_fd_t *e = io_fd(fd);
+    if(!e){
+        return -1;
+    }
+    for(;;){
+        ssize_t r = read(fd, buf, count);
+        if(r >= 0 || (errno != EINTR && !io_bloqueou())){
+            return r;
+        }
+        if(errno != EINTR){
+            io_wait(e, 0);
+        }
+    }
+}
+
+ssize_t pp_write (int fd, const void *buf, size_t count){
+
+    io_fd_t *e = io_fd(fd);
+    if(!e){
+        return -1;
+    }
+    for(;;){
+        ssize_t r = write(fd, buf, count);
+        if(r >= 0 || (errno != EINTR && !io_bloqueou())){
+            return r;
+        }
+        if(errno != EINTR){
+            io_wait(e, 1);
+        }
+    }
+}
+
+int pp_accept (int fd, struct sockaddr *addr, socklen_t *addrlen){
+
+    io_fd_t *e = io_fd(fd);
+    if(!e){
+        return -1;
+    }
+    for(;;){
+        int novo = accept(fd, addr, addrlen);
+        if(novo >= 0){
+            if(!io_fd(novo)){           //A conexão aceita também não bloqueia o processo
+                close(novo);
+                return -1;
+            }
+            return novo;
+        }
+        if(errno != EINTR && !io_bloqueou() && errno != ECONNABORTED){
+            return -1;
+        }
+        if(io_bloqueou()){
+            io_wait(e, 0);
+        }
+    }
+}
+
+int pp_connect (int fd, const struct sockaddr *addr, socklen_t addrlen){
+
+    io_fd_t *e = io_fd(fd);
+    if(!e){
+        return -1;
+    }
+    if(connect(fd, addr, addrlen) == 0){
+        return 0;
+    }
+    if(errno != EINPROGRESS && errno != EINTR){
+        return -1;
+    }
+
+    //Conexão em andamento: espera o descritor ficar gravável e consulta o resultado
+    int erro = 0;
+    socklen_t tam = sizeof(erro);
+    for(;;){
+        io_wait(e, 1);
+        if(getsockopt(fd, SOL_SOCKET, SO_ERROR, &erro, &tam) < 0){
+            return -1;
+        }
+        if(erro){
+            errno = erro;
+            return -1;
+        }
+
+        //Sem erro e com par conectado: concluída (senão foi um evento anterior ao connect)
+        struct sockaddr_storage par;
+        socklen_t tam_par = sizeof(par);
+        if(getpeername(fd, (struct sockaddr *) &par, &tam_par) == 0){
+            return 0;
+        }
+        if(errno != ENOTCONN){
+            return -1;
+        }
+    }
+}
+
+//Fecha um descritor usado pelas operações pp_*, acordando quem o esperava
+int pp_close (int fd){
+
+    if(fd >= 0 && fd < io_nfds){
+        preempt_disable();
+        io_acorda(&io_fds[fd].leitores);
+        io_acorda(&io_fds[fd].escritores);
+        if(io_fds[fd].preparado){
+            epoll_ctl(io_epoll, EPOLL_CTL_DEL, fd, NULL);  //O número pode voltar num novo descritor
+        }
+        io_fds[fd].leitores = NULL;
+        io_fds[fd].escritores = NULL;
+        io_fds[fd].preparado = 0;
+        io_fds[fd].legivel = 0;
+        io_fds[fd].gravavel = 0;
+        io_fds[fd].aviso = NULL;
+        preempt_enable();
+    }
+    return close(fd);
+}
@@ -0,0 +1,200 @@
+// PingPongOS - PingPong Operating System
+//
+// Contadores de desempenho do processador por tarefa. Os contadores
+// (ciclos, instruções, falhas de cache e de previsão de desvio) são abertos
+// com perf_event_open para a thread das tarefas, só em modo usuário; a cada
+// troca de contexto o núcleo lê os contadores e atribui a diferença à tarefa
+// que deixa o processador. A leitura usa rdpmc quando o núcleo do sistema a
+// permite (x86) e, caso contrário, uma única chamada read do grupo.
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <linux/perf_event.h>
+
+#include "pingpong.h"
+#include "kernel.h"
+
+// eventos medidos, na ordem de task_t.perf
+static const unsigned long long perf_config[PERF_EVENTOS] = {
+    PERF_COUNT_HW_CPU_CYCLES,
+    PERF_COUNT_HW_INSTRUCTIONS,
+    PERF_COUNT_HW_CACHE_MISSES,
+    PERF_COUNT_HW_BRANCH_MISSES,
+};
+
+int perf_ativo = 0;                         //Contadores abertos (pingpong_set_perf)
+int perf_fd[PERF_EVENTOS] = { -1, -1, -1, -1 };   //Descritor de cada evento (-1: indisponível)
+struct perf_event_mmap_page *perf_pagina[PERF_EVENTOS];   //Páginas para rdpmc (NULL: usa read)
+int perf_lider = -1;                        //Líder do grupo (o primeiro evento aberto)
+int perf_rdpmc = 0;                         //Todos os eventos abertos podem ser lidos com rdpmc
+unsigned long long perf_anterior[PERF_EVENTOS];   //Valores na última troca
+
+//Lê um contador pela página mapeada, sem chamada de sistema
+static inline unsigned long long perf_le_rdpmc(struct perf_event_mmap_page *pg){
+#if defined(__x86_64__) || defined(__i386__)
+    unsigned int seq, idx;
+    unsigned long long valor;
+
+    do{
+        seq = pg->lock;
+        __atomic_signal_fence(__ATOMIC_SEQ_CST);
+        idx = pg->index;
+        valor = pg->offset;
+        if(idx){
+            unsigned int lo, hi;
+            __asm__ volatile("rdpmc" : "=a" (lo), "=d" (hi) : "c" (idx - 1));
+            long long pmc = ((unsigned long long) hi << 32) | lo;
+            int largura = pg->pmc_width;
+            pmc <<= 64 - largura;           //Estende o sinal do contador de largura pmc_width
+            pmc >>= 64 - largura;
+            valor += pmc;
+        }
+        __atomic_signal_fence(__ATOMIC_SEQ_CST);
+    } while(pg->lock != seq);
+    return valor;
+#else
+    (void) pg;
+    return 0;
+#endif
+}
+
+//Lê os contadores abertos; os indisponíveis ficam em zero
+void perf_le(unsigned long long valores[PERF_EVENTOS]){
+
+    memset(valores, 0, PERF_EVENTOS * sizeof(unsigned long long));
+
+    if(perf_rdpmc){
+        for(int i = 0; i < PERF_EVENTOS; i++){
+            if(perf_pagina[i]){
+                valores[i] = perf_le_rdpmc(perf_pagina[i]);
+            }
+        }
+        return;
+    }
+
+    //PERF_FORMAT_GROUP: quantidade de eventos seguida dos valores, na ordem de abertura
+    unsigned long long grupo[PERF_EVENTOS + 1];
+    if(read(perf_lider, grupo, sizeof(grupo)) < (ssize_t) sizeof(unsigned long long)){
+        return;
+    }
+    int j = 1;
+    for(int i = 0; i < PERF_EVENTOS && j <= (int) grupo[0]; i++){
+        if(perf_fd[i] >= 0){
+            valores[i] = grupo[j++];
+        }
+    }
+}
+
+void perf_troca(task_t *task){
+
+    unsigned long long atual[PERF_EVENTOS];
+    perf_le(atual);
+    for(int i = 0; i < PERF_EVENTOS; i++){
+        task->perf[i] += atual[i] - perf_anterior[i];
+        perf_anterior[i] = atual[i];
+    }
+}
+
+//Fecha todos os contadores
+void perf_fecha(){
+
+    for(int i = 0; i < PERF_EVENTOS; i++){
+        if(perf_pagina[i]){
+            munmap(perf_pagina[i], sysconf(_SC_PAGESIZE));
+            perf_pagina[i] = NULL;
+        }
+    }
+    for(int i = PERF_EVENTOS - 1; i >= 0; i--){      //O líder por último
+        if(perf_fd[i] >= 0){
+            close(perf_fd[i]);
+            perf_fd[i] = -1;
+        }
+    }
+    perf_lider = -1;
+    perf_rdpmc = 0;
+}
+
+int pingpong_set_perf (int ligado){
+
+    preempt_disable();
+
+    if(perf_ativo){
+        perf_ativo = 0;
+        perf_fecha();
+    }
+    if(!ligado){
+        preempt_enable();
+        return 0;
+    }
+
+    int abertos = 0;
+    perf_rdpmc = 1;
+    for(int i = 0; i < PERF_EVENTOS; i++){
+        struct perf_event_attr attr;
+        memset(&attr, 0, sizeof(attr));
+        attr.size = sizeof(attr);
+        attr.type = PERF_TYPE_HARDWARE;
+        attr.config = perf_config[i];
+        attr.exclude_kernel = 1;            //Permitido com perf_event_paranoid <= 2
+        attr.exclude_hv = 1;
+        attr.read_format = PERF_FORMAT_GROUP;
+
+        perf_fd[i] = syscall(__NR_perf_event_open, &attr, 0, -1, perf_lider, 0);
+        perf_pagina[i] = NULL;
+        if(perf_fd[i] < 0){                 //Evento inexistente (máquina virtual, processador)
+            perf_fd[i] = -1;
+            continue;
+        }
+        if(perf_lider < 0){
+            perf_lider = perf_fd[i];
+        }
+        abertos++;
+
+        void *pg = mmap(NULL, sysconf(_SC_PAGESIZE), PROT_READ, MAP_SHARED, perf_fd[i], 0);
+        if(pg != MAP_FAILED){
+            perf_pagina[i] = pg;
+        }
+        if(pg == MAP_FAILED || !perf_pagina[i]->cap_user_rdpmc){
+            perf_rdpmc = 0;
+        }
+    }
+#if !defined(__x86_64__) && !defined(__i386__)
+    perf_rdpmc = 0;
+#endif
+
+    if(!abertos){
+        perf_fecha();
+        preempt_enable();
+        return -1;
+    }
+
+    perf_le(perf_anterior);
+    perf_ativo = 1;
+    preempt_enable();
+    return abertos;
+}
+
+void perf_task_init(task_t *task){
+
+    for(int i = 0; i < PERF_EVENTOS; i++){
+        task->perf[i] = 0;
+    }
+}
+
+void perf_init(){
+
+    if(!perf_ativo){                    //pingpong_set_perf(1) antes de pingpong_init: já abertos
+        for(int i = 0; i < PERF_EVENTOS; i++){
+            perf_fd[i] = -1;
+        }
+    }
+
+    char *modo = getenv("PINGPONG_PERF");
+    if(modo && *modo && *modo != '0' && pingpong_set_perf(1) < 0){
+        perror("Contadores de desempenho indisponíveis: ");
+    }
+}
@@ -0,0 +1,188 @@
+// PingPongOS - PingPong Operating System
+//
+// Threads auxiliares para trabalhos que bloqueariam o processo (E/S de
+// arquivos sem io_uring, task_offload). A tarefa que submete o trabalho é
+// suspensa; uma thread auxiliar o executa e o empilha nos concluídos (pilha
+// sem trava), avisando o despachante por um eventfd observado pelo epoll.
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <errno.h>
+#include <signal.h>
+#include <unistd.h>
+#include <pthread.h>
+#include <sys/eventfd.h>
+
+#include "pingpong.h"
+#include "kernel.h"
+
+// o núcleo usa threads do sistema internamente; as aplicações continuam
+// proibidas de usá-las (ver pingpong.h)
+#undef pthread_create
+#undef pthread_mutex_lock
+#undef pthread_mutex_unlock
+#undef pthread_cond_wait
+#undef pthread_cond_signal
+
+#define POOL_THREADS    4           /* threads auxiliares */
+
+pthread_mutex_t pool_trava = PTHREAD_MUTEX_INITIALIZER;
+pthread_cond_t pool_cond = PTHREAD_COND_INITIALIZER;
+pool_job_t *pool_fila = NULL;           //Trabalhos aguardando uma thread (FIFO)
+pool_job_t *pool_fila_fim = NULL;
+pool_job_t *pool_concluidos = NULL;     //Pilha sem trava de concluídos, a colher pelo despachante
+int pool_aviso = -1;                    //eventfd que acorda o despachante
+int pool_iniciado = 0;                  //1: threads criadas; -1: falhou, os trabalhos bloqueiam o processo
+
+//Corpo das threads auxiliares: executa trabalhos até o fim do processo
+void *pool_thread(void *arg){
+    (void) arg;
+
+    for(;;){
+        pthread_mutex_lock(&pool_trava);
+        while(!pool_fila){
+            pthread_cond_wait(&pool_cond, &pool_trava);
+        }
+        pool_job_t *job = pool_fila;
+        pool_fila = job->prox;
+        pthread_mutex_unlock(&pool_trava);
+
+        job->executa(job);
+
+        //Empilha nos concluídos sem trava: o despachante nunca espera por uma thread auxiliar
+        pool_job_t *topo = __atomic_load_n(&pool_concluidos, __ATOMIC_RELAXED);
+        do{
+            job->prox = topo;
+        } while(!__atomic_compare_exchange_n(&pool_concluidos, &topo, job, 1,
+                                             __ATOMIC_RELEASE, __ATOMIC_RELAXED));
+
+        uint64_t um = 1;
+        if(write(pool_aviso, &um, sizeof(um)) < 0){
+            perror("Erro ao avisar o despachante: ");
+        }
+    }
+    return NULL;
+}
+
+//Esvazia o eventfd e colhe os concluídos
+void pool_aviso_pronto(int fd){
+    uint64_t n;
+    while(read(fd, &n, sizeof(n)) > 0);
+    pool_drain();
+}
+
+//Desiste das threads auxiliares: fecha o eventfd e não tenta de novo
+static int pool_falha(){
+
+    if(pool_aviso >= 0){
+        pp_close(pool_aviso);               //Também o retira do epoll, se io_watch o registrou
+        pool_aviso = -1;
+    }
+    pool_iniciado = -1;
+    return -1;
+}
+
+//Cria o eventfd e as threads auxiliares no primeiro uso
+int pool_init(){
+
+    pool_aviso = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+    if(pool_aviso < 0 || io_watch(pool_aviso, pool_aviso_pronto)){
+        return pool_falha();
+    }
+
+    //As threads auxiliares não recebem sinais: o SIGALRM é sempre da thread das tarefas
+    sigset_t todos, anterior;
+    sigfillset(&todos);
+    pthread_sigmask(SIG_SETMASK, &todos, &anterior);
+
+    int criadas = 0;
+    for(int i = 0; i < POOL_THREADS; i++){
+        pthread_t thread;
+        if(pthread_create(&thread, NULL, pool_thread, NULL) == 0){
+            pthread_detach(thread);
+            criadas++;
+        }
+    }
+    pthread_sigmask(SIG_SETMASK, &anterior, NULL);
+
+    if(!criadas){
+        return pool_falha();
+    }
+    pool_iniciado = 1;
+    return 0;
+}
+
+//Entrega um trabalho às threads auxiliares
+int pool_submit(pool_job_t *job){
+
+    if(pool_iniciado < 0 || (!pool_iniciado && pool_init())){
+        return -1;
+    }
+
+    job->prox = NULL;
+    pthread_mutex_lock(&pool_trava);
+    if(pool_fila){
+        pool_fila_fim->prox = job;
+    }
+    else{
+        pool_fila = job;
+    }
+    pool_fila_fim = job;
+    pthread_cond_signal(&pool_cond);
+    pthread_mutex_unlock(&pool_trava);
+
+    return 0;
+}
+
+//Colhe os trabalhos concluídos, acordando as tarefas que os esperavam
+void pool_drain(){
+
+    if(!__atomic_load_n(&pool_concluidos, __ATOMIC_RELAXED)){
+        return;
+    }
+
+    //Toma a pilha inteira de uma vez (sem ABA: só o despachante retira)
+    pool_job_t *pilha = __atomic_exchange_n(&pool_concluidos, NULL, __ATOMIC_ACQUIRE);
+
+    pool_job_t *job = NULL;             //Inverte a pilha: conclusões na ordem em que ocorreram
+    while(pilha){
+        pool_job_t *prox = pilha->prox;
+        pilha->prox = job;
+        job = pilha;
+        pilha = prox;
+    }
+
+    while(job){
+        pool_job_t *prox = job->prox;
+        aio_done(job);
+        job = prox;
+    }
+}
+
+//Executa a função de task_offload numa thread auxiliar
+void pool_executa_funcao(pool_job_t *job){
+    errno = 0;
+    job->retorno = job->funcao(job->buf);
+    job->erro = errno;
+}
+
+void *task_offload (void *(*fn)(void *), void *arg){
+
+    pool_job_t job;
+    job.executa = pool_executa_funcao;
+    job.funcao = fn;
+    job.buf = arg;
+    job.erro = 0;
+
+    preempt_disable();                  //Submissão e suspensão sem o despachante no meio
+    if(pool_submit(&job) == 0){
+        aio_wait(&job);
+    }
+    else{
+        job.executa(&job);              //Sem threads auxiliares: bloqueia o processo
+    }
+    preempt_enable();
+
+    errno = job.erro;
+    return job.retorno;
+}
@@ -0,0 +1,212 @@
+// PingPongOS - PingPong Operating System
+//
+// Estatísticas do escalonador: contadores globais para amostragem periódica
+// e latência entre a tarefa ficar pronta e ser despachada, em histogramas
+// logarítmicos por tarefa e por prioridade.
+
+#include <stdio.h>
+#include <string.h>
+
+#include "pingpong.h"
+#include "kernel.h"
+
+#define PRIO_NIVEIS     (PRIO_MIN - PRIO_MAX + 1)
+
+task_t *tarefas_vivas = NULL;               //Tarefas de usuário ainda não encerradas
+struct pp_stats pp_contadores;              //Contadores globais
+pp_hist_t latencia_prio[PRIO_NIVEIS];       //Latência por prioridade estática (inclui tarefas encerradas)
+
+// histogramas ================================================================
+
+//Balde de uma duração: exato abaixo de 2^HIST_SUB_BITS, depois
+//2^HIST_SUB_BITS baldes por potência de 2
+int hist_balde(unsigned long long v){
+
+    if(v < (1 << HIST_SUB_BITS)){
+        return v;
+    }
+    int e = 63 - __builtin_clzll(v);    //Potência de 2 de v
+    if(e > HIST_OITAVAS){
+        return HIST_BALDES - 1;
+    }
+    int sub = (v >> (e - HIST_SUB_BITS)) & ((1 << HIST_SUB_BITS) - 1);
+    return ((e - HIST_SUB_BITS + 1) << HIST_SUB_BITS) + sub;
+}
+
+//Maior duração que cai no balde b
+long long hist_limite(int b){
+
+    if(b < (1 << HIST_SUB_BITS)){
+        return b;
+    }
+    int e = (b >> HIST_SUB_BITS) + HIST_SUB_BITS - 1;
+    int sub = b & ((1 << HIST_SUB_BITS) - 1);
+    long long base = (long long) ((1 << HIST_SUB_BITS) + sub) << (e - HIST_SUB_BITS);
+    return base + (1LL << (e - HIST_SUB_BITS)) - 1;
+}
+
+void hist_registra(pp_hist_t *h, long long ns){
+
+    if(ns < 0){
+        ns = 0;
+    }
+    h->baldes[hist_balde(ns)]++;
+    h->n++;
+    if((count_t) ns > h->max){
+        h->max = ns;
+    }
+}
+
+long long hist_percentil(pp_hist_t *h, double p){
+
+    if(!h->n){
+        return 0;
+    }
+    count_t alvo = p * h->n;
+    if(alvo < p * h->n || alvo < 1){    //Arredonda para cima
+        alvo++;
+    }
+    count_t acumulado = 0;
+    for(int b = 0; b < HIST_BALDES; b++){
+        acumulado += h->baldes[b];
+        if(acumulado >= alvo){
+            long long limite = hist_limite(b);
+            return limite < (long long) h->max ? limite : (long long) h->max;
+        }
+    }
+    return h->max;
+}
+
+// registro das tarefas (removido com ESTATISTICAS=0) ========================
+#if PP_ESTATISTICAS
+
+void stats_task_new(task_t *task){
+
+    memset(&task->latencia, 0, sizeof(pp_hist_t));
+    task->pronta_em = 0;
+
+    if(tarefas_vivas){
+        task->viva_prox = tarefas_vivas;
+        task->viva_ant = tarefas_vivas->viva_ant;
+        tarefas_vivas->viva_ant->viva_prox = task;
+        tarefas_vivas->viva_ant = task;
+    }
+    else{
+        task->viva_prox = task->viva_ant = task;
+        tarefas_vivas = task;
+    }
+}
+
+void stats_task_exit(task_t *task){
+
+    if(!task->viva_prox){
+        return;
+    }
+    if(task->viva_prox == task){
+        tarefas_vivas = NULL;
+    }
+    else{
+        task->viva_ant->viva_prox = task->viva_prox;
+        task->viva_prox->viva_ant = task->viva_ant;
+        if(tarefas_vivas == task){
+            tarefas_vivas = task->viva_prox;
+        }
+    }
+    task->viva_prox = task->viva_ant = NULL;
+}
+
+void stats_pronta(task_t *task){
+    task->pronta_em = relogio_ns();
+}
+
+void stats_executa(task_t *task){
+
+    if(!task->pronta_em){               //Já contabilizada (task_set_executing é chamada mais de uma vez)
+        return;
+    }
+    long long espera = relogio_ns() - task->pronta_em;
+    task->pronta_em = 0;
+
+    hist_registra(&task->latencia, espera);
+    int prio = task->prio_estat;
+    if(prio >= PRIO_MAX && prio <= PRIO_MIN){
+        hist_registra(&latencia_prio[prio - PRIO_MAX], espera);
+    }
+}
+
+#endif
+
+// amostras ===================================================================
+
+void pingpong_get_stats (struct pp_stats *stats){
+
+    preempt_disable();                  //Cópia consistente: nenhuma troca durante a leitura
+    *stats = pp_contadores;
+    preempt_enable();
+
+    stats->vivas = stats->criadas + 1 - stats->encerradas;   //+1: a tarefa principal
+    stats->prontas = n_prontas;
+    stats->relogio = systime();
+}
+
+int pingpong_get_task_stats (struct pp_task_stats *v, int max){
+
+    int n = 0;
+    preempt_disable();
+
+    task_t *task = tarefas_vivas;
+    if(task && max > 0){
+        do{
+            v[n].id = task->id;
+            v[n].status = task->status;
+            v[n].prio = task->prio_estat;
+            v[n].cpu_ms = task->t_executado;
+            v[n].ativacoes = task->contador_processo;
+            v[n].quantum = task_quantum(task);
+            v[n].quantum_medio = task->contador_processo ? task->quantum_total / task->contador_processo : 0;
+            v[n].latencia_n = task->latencia.n;
+            v[n].latencia_p99_ns = hist_percentil(&task->latencia, 0.99);
+            v[n].ciclos = task->perf[0];
+            v[n].instrucoes = task->perf[1];
+            v[n].falhas_cache = task->perf[2];
+            v[n].falhas_desvio = task->perf[3];
+            n++;
+            task = task->viva_prox;
+        } while(task != tarefas_vivas && n < max);
+    }
+
+    preempt_enable();
+    return n;
+}
+
+// relatório =================================================================
+
+//Uma linha do relatório: amostras e percentis em microssegundos
+void stats_linha(const char *rotulo, int id, pp_hist_t *h){
+    printf("%s %d latency: %llu samples, p50 %.1f us, p99 %.1f us, p99.9 %.1f us, max %.1f us\n",
+        rotulo, id, h->n, hist_percentil(h, 0.50) / 1000.0, hist_percentil(h, 0.99) / 1000.0,
+        hist_percentil(h, 0.999) / 1000.0, h->max / 1000.0);
+}
+
+void pingpong_stats_dump (){
+
+    preempt_disable();
+
+    task_t *task = tarefas_vivas;
+    if(task){
+        do{
+            if(task->latencia.n){
+                stats_linha("Task", task->id, &task->latencia);
+            }
+            task = task->viva_prox;
+        } while(task != tarefas_vivas);
+    }
+
+    for(int i = 0; i < PRIO_NIVEIS; i++){
+        if(latencia_prio[i].n){
+            stats_linha("Priority", i + PRIO_MAX, &latencia_prio[i]);
+        }
+    }
+
+    preempt_enable();
+}
@@ -0,0 +1,109 @@
+// PingPongOS - PingPong Operating System
+//
+// Armazenamento local das tarefas. Os valores das primeiras TLS_SLOTS chaves
+// ficam no próprio descritor da tarefa; os das demais, numa tabela alocada
+// na primeira vez que a tarefa define uma delas. A leitura custa um teste e
+// um ou dois acessos à memória, sem busca pela tarefa.
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "pingpong.h"
+#include "kernel.h"
+
+#define TLS_ITERACOES   4           /* passadas pelos destrutores que definem novos valores */
+
+int tls_chaves = 0;                                 //Chaves já criadas
+void (*tls_destrutores[TLS_CHAVES]) (void *);       //Destrutor de cada chave
+
+int task_key_create (task_key_t *key, void (*destrutor)(void *)){
+
+    if(!key){
+        return -1;
+    }
+
+    preempt_disable();                  //Duas tarefas não podem receber a mesma chave
+    if(tls_chaves == TLS_CHAVES){
+        preempt_enable();
+        return -1;
+    }
+    tls_destrutores[tls_chaves] = destrutor;
+    *key = tls_chaves++;
+    preempt_enable();
+
+    return 0;
+}
+
+void *task_getspecific (task_key_t key){
+
+    if((unsigned) key < TLS_SLOTS){
+        return tarefa_atual->tls[key];
+    }
+    if((unsigned) key >= (unsigned) tls_chaves || !tarefa_atual->tls_extra){
+        return NULL;
+    }
+    return tarefa_atual->tls_extra[key - TLS_SLOTS];
+}
+
+int task_setspecific (task_key_t key, const void *valor){
+
+    if((unsigned) key >= (unsigned) tls_chaves){
+        return -1;
+    }
+    if(key < TLS_SLOTS){
+        tarefa_atual->tls[key] = (void *) valor;
+        return 0;
+    }
+
+    if(!tarefa_atual->tls_extra){
+        preempt_disable();              //Nenhuma troca com o alocador em uso
+        tarefa_atual->tls_extra = calloc(TLS_CHAVES - TLS_SLOTS, sizeof(void *));
+        preempt_enable();
+        if(!tarefa_atual->tls_extra){
+            return -1;
+        }
+    }
+    tarefa_atual->tls_extra[key - TLS_SLOTS] = (void *) valor;
+    return 0;
+}
+
+//Endereço do valor da chave na tarefa (NULL se a tabela extra não foi alocada)
+static void **tls_valor(task_t *task, int key){
+
+    if(key < TLS_SLOTS){
+        return &task->tls[key];
+    }
+    return task->tls_extra ? &task->tls_extra[key - TLS_SLOTS] : NULL;
+}
+
+void tls_task_exit(task_t *task){
+
+    //Como em pthread: cada valor é zerado antes do destrutor, e a passada se
+    //repete enquanto os destrutores definirem novos valores
+    for(int iteracao = 0; iteracao < TLS_ITERACOES; iteracao++){
+        int chamou = 0;
+        for(int key = 0; key < tls_chaves; key++){
+            void **valor = tls_valor(task, key);
+            if(!valor || !*valor || !tls_destrutores[key]){
+                continue;
+            }
+            void *antigo = *valor;
+            *valor = NULL;
+            tls_destrutores[key](antigo);
+            chamou = 1;
+        }
+        if(!chamou){
+            break;
+        }
+    }
+
+    for(int key = 0; key < TLS_SLOTS; key++){
+        task->tls[key] = NULL;          //O descritor pode ser reutilizado por task_create
+    }
+    if(task->tls_extra){
+        preempt_disable();
+        free(task->tls_extra);
+        preempt_enable();
+        task->tls_extra = NULL;
+    }
+}
@@ -0,0 +1,85 @@
+// PingPongOS - PingPong Operating System
+//
+// Anel de rastreamento do núcleo (ver pp_trace.h). Há um único escalonador,
+// numa única thread, portanto um único anel; as threads auxiliares não
+// registram eventos. Com a variável de ambiente PINGPONG_TRACE=<arquivo>, o
+// rastreamento é ligado em pingpong_init e o anel é salvo no fim do processo.
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "pingpong.h"
+#include "kernel.h"
+
+int trace_ligado = 0;
+uint64_t trace_pos = 0;
+trace_reg_t trace_anel[TRACE_REGISTROS];
+
+uint64_t trace_instante0, trace_ns0;    //Referência para converter instantes em ns
+const char *trace_arquivo = NULL;       //Arquivo de PINGPONG_TRACE
+
+//Relógio monotônico em nanossegundos
+uint64_t trace_ns(){
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec * 1000000000ULL + ts.tv_nsec;
+}
+
+void pingpong_trace (int ligado){
+
+    if(ligado && !trace_instante0){
+        trace_instante0 = trace_instante();
+        trace_ns0 = trace_ns();
+    }
+    trace_ligado = ligado;
+}
+
+int pingpong_trace_dump (const char *arquivo){
+
+    FILE *f = fopen(arquivo, "wb");
+    if(!f){
+        return -1;
+    }
+
+    int ligado = trace_ligado;
+    trace_ligado = 0;                   //Nenhum registro novo durante a cópia
+
+    trace_cabecalho_t cab;
+    memcpy(cab.magico, TRACE_MAGICO, sizeof(cab.magico));
+    uint64_t fim = trace_pos;
+    uint64_t inicio = fim > TRACE_REGISTROS ? fim - TRACE_REGISTROS : 0;   //Os mais antigos foram sobrescritos
+    cab.n = fim - inicio;
+    cab.instante0 = trace_instante0;
+    cab.ns0 = trace_ns0;
+    cab.instante1 = trace_instante();
+    cab.ns1 = trace_ns();
+
+    int erro = fwrite(&cab, sizeof(cab), 1, f) != 1;
+    for(uint64_t i = inicio; i < fim && !erro; i++){
+        erro = fwrite(&trace_anel[i & (TRACE_REGISTROS - 1)], sizeof(trace_reg_t), 1, f) != 1;
+    }
+
+    trace_ligado = ligado;
+    if(fclose(f) || erro){
+        return -1;
+    }
+    return 0;
+}
+
+//Salva o anel no arquivo de PINGPONG_TRACE ao fim do processo
+void trace_salva(){
+    if(pingpong_trace_dump(trace_arquivo)){
+        perror("Erro ao salvar o rastreamento: ");
+    }
+}
+
+void trace_init(){
+
+    trace_arquivo = getenv("PINGPONG_TRACE");
+    if(trace_arquivo && *trace_arquivo){
+        pingpong_trace(1);
+        atexit(trace_salva);
+    }
+}
@@ -0,0 +1,95 @@
+// PingPongOS - PingPong Operating System
+//
+// Pontos de rastreamento do núcleo: cada evento grava um registro binário de
+// tamanho fixo num anel em memória, sem printf nem chamadas de sistema. O anel
+// é salvo com pingpong_trace_dump e decodificado fora do programa (tracedump).
+
+#ifndef __PP_TRACE__
+#define __PP_TRACE__
+
+#include <stdint.h>
+#include <time.h>
+
+#define TRACE_MAGICO    "PPTRACE1"  /* início do arquivo salvo */
+#define TRACE_REGISTROS 65536       /* registros no anel (potência de 2) */
+
+// eventos registrados (campos a e b de cada um em tracedump.c)
+enum trace_evento
+{
+    TR_INIT = 1,        //Sistema inicializado
+    TR_CRIA,            //Tarefa criada: a = prioridade, b = quantum
+    TR_SAIDA,           //Tarefa encerrada: a = código de saída, b = tempo de processador
+    TR_TROCA,           //Troca de contexto: a = tarefa que entra, b = ativações dela
+    TR_SUSPENDE,        //Tarefa suspensa
+    TR_RETOMA,          //Tarefa acordada
+    TR_CEDE,            //task_yield
+    TR_ESCOLHE,         //Escolha do escalonador: a = tarefas prontas
+    TR_TICK,            //Tick de relógio: a = ticks restantes do quantum, b = tempo de processador
+    TR_DORME,           //task_sleep: a = instante de acordar
+    TR_JOIN,            //task_join: a = tarefa aguardada
+    TR_JOIN_FIM,        //Retorno de task_join: a = tarefa aguardada, b = código de saída
+    TR_DESACOPLA,       //task_detach
+    TR_OCIOSO,          //Despachante ocioso: a = prazo da espera (0 se esperar E/S)
+    TR_CANCELA,         //task_cancel: a = tarefa que pediu o cancelamento
+    TR_EVENTOS
+};
+
+// registro de um evento (24 bytes, gravado no arquivo como está na memória)
+typedef struct trace_reg_t
+{
+    uint64_t instante;      //Ciclos do TSC (x86) ou nanossegundos do relógio monotônico
+    uint16_t evento;
+    uint16_t reservado;
+    int32_t tarefa;
+    int32_t a;
+    int32_t b;
+} trace_reg_t ;
+
+// cabeçalho do arquivo salvo, seguido de n registros do mais antigo ao mais novo;
+// os dois pares (instante, ns) convertem o instante dos registros em nanossegundos
+typedef struct trace_cabecalho_t
+{
+    char magico[8];
+    uint64_t n;
+    uint64_t instante0, ns0;
+    uint64_t instante1, ns1;
+} trace_cabecalho_t ;
+
+extern int trace_ligado;                //Rastreamento ativo (pingpong_trace)
+extern uint64_t trace_pos;              //Registros já gravados (a posição no anel é trace_pos % TRACE_REGISTROS)
+extern trace_reg_t trace_anel[TRACE_REGISTROS];
+
+//Instante atual para os registros: alguns ns no x86, sem chamada de sistema
+static inline uint64_t trace_instante(){
+#if defined(__x86_64__) || defined(__i386__)
+    return __builtin_ia32_rdtsc();
+#else
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec * 1000000000ULL + ts.tv_nsec;
+#endif
+}
+
+//Grava um registro; pode ser interrompida pelo tick, que também grava
+//(a reserva atômica da posição garante registros distintos)
+static inline void trace_registra(int evento, int tarefa, int a, int b){
+    uint64_t pos = __atomic_fetch_add(&trace_pos, 1, __ATOMIC_RELAXED);
+    trace_reg_t *r = &trace_anel[pos & (TRACE_REGISTROS - 1)];
+    r->instante = trace_instante();
+    r->evento = evento;
+    r->reservado = 0;
+    r->tarefa = tarefa;
+    r->a = a;
+    r->b = b;
+}
+
+//Ponto de rastreamento: um teste de variável quando desligado; removido ao
+//compilar com TRACE=0 (pingpong_config.h) ou -DPP_SEM_TRACE
+#ifndef PP_SEM_TRACE
+#define TRACE(evento, tarefa, a, b) \
+    do{ if(__builtin_expect(trace_ligado, 0)) trace_registra(evento, tarefa, a, b); } while(0)
+#else
+#define TRACE(evento, tarefa, a, b) do{ } while(0)
+#endif
+
+#endif
@@ -0,0 +1,136 @@
+// PingPongOS - PingPong Operating System
+//
+// Troca de contexto entre tarefas. O mecanismo é escolhido na compilação
+// (make TROCA=ucontext|asm, PP_TROCA_ASM em pingpong_config.h):
+//  - ucontext (padrão): getcontext/makecontext/swapcontext da libc, portável;
+//    cada troca salva e restaura a máscara de sinais (uma chamada de sistema).
+//  - asm (x86-64): salva apenas os registradores preservados pela ABI e o
+//    ponteiro de pilha, sem chamada de sistema. A máscara de sinais não é
+//    trocada: quando a tarefa que sai estava no tratador do SIGALRM (preempção),
+//    a tarefa que entra desbloqueia o sinal, que o tratador mantinha bloqueado.
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <signal.h>
+
+#include "pingpong.h"
+#include "kernel.h"
+
+#if PP_TROCA_ASM && !defined(__x86_64__)
+#error "TROCA=asm disponível apenas em x86-64"
+#endif
+
+volatile sig_atomic_t em_tratador = 0;     //A tarefa atual está dentro do tratador do timer
+
+#if PP_TROCA_ASM
+
+//Salva rbx, rbp, r12-r15 e rsp da tarefa que sai em *salva e retoma a pilha nova
+void pp_troca_asm(void **salva, void *nova);
+
+//Primeiro retorno de uma tarefa nova: r12 = função, r13 = argumento
+void pp_troca_entrada();
+
+__asm__(
+    ".text\n"
+    ".globl pp_troca_asm\n"
+    ".hidden pp_troca_asm\n"
+    ".type pp_troca_asm, @function\n"
+    "pp_troca_asm:\n"
+    "   pushq %rbp\n"
+    "   pushq %rbx\n"
+    "   pushq %r12\n"
+    "   pushq %r13\n"
+    "   pushq %r14\n"
+    "   pushq %r15\n"
+    "   movq %rsp, (%rdi)\n"
+    "   movq %rsi, %rsp\n"
+    "   popq %r15\n"
+    "   popq %r14\n"
+    "   popq %r13\n"
+    "   popq %r12\n"
+    "   popq %rbx\n"
+    "   popq %rbp\n"
+    "   ret\n"
+    ".size pp_troca_asm, .-pp_troca_asm\n"
+    ".globl pp_troca_entrada\n"
+    ".hidden pp_troca_entrada\n"
+    ".type pp_troca_entrada, @function\n"
+    "pp_troca_entrada:\n"
+    "   movq %r12, %rdi\n"
+    "   movq %r13, %rsi\n"
+    "   andq $-16, %rsp\n"
+    "   call contexto_inicio\n"
+    "   ud2\n"
+    ".size pp_troca_entrada, .-pp_troca_entrada\n"
+);
+
+//A tarefa que acabou de passar o processador estava no tratador do timer:
+//o SIGALRM continua bloqueado e deve ser liberado para a tarefa que entra
+static void contexto_retoma(){
+
+    if(em_tratador){
+        sigset_t alarme;
+        sigemptyset(&alarme);
+        sigaddset(&alarme, SIGALRM);
+        sigprocmask(SIG_UNBLOCK, &alarme, 0);
+    }
+}
+
+//Corpo inicial de toda tarefa criada pelo backend asm
+__attribute__((used, noreturn))
+void contexto_inicio(void (*inicio)(void*), void *arg){
+
+    contexto_retoma();
+    em_tratador = 0;
+    inicio(arg);
+    exit(0);                        //Mesmo efeito de uc_link nulo: a tarefa retornou sem task_exit
+}
+
+void contexto_cria(task_t *task, char *pilha, void (*inicio)(void*), void *arg){
+
+    task->context.uc_stack.ss_sp = pilha;   //Usada por task_release para devolver a pilha
+    task->context.uc_stack.ss_size = STACKSIZE;
+    task->context.uc_stack.ss_flags = 0;
+    task->context.uc_link = 0;
+
+    //Quadro que pp_troca_asm desempilha: r15, r14, r13, r12, rbx, rbp e o retorno
+    void **sp = (void **) (((unsigned long) (pilha + STACKSIZE)) & ~15UL) - 8;
+    sp[0] = 0;                      //r15
+    sp[1] = 0;                      //r14
+    sp[2] = arg;                    //r13
+    sp[3] = (void *) inicio;        //r12
+    sp[4] = 0;                      //rbx
+    sp[5] = 0;                      //rbp
+    sp[6] = (void *) pp_troca_entrada;
+    sp[7] = 0;
+    task->contexto_sp = sp;
+}
+
+void contexto_troca(task_t *sai, task_t *entra){
+
+    sig_atomic_t tratador = em_tratador;   //Restaurado quando a tarefa que sai voltar
+
+    pp_troca_asm(&sai->contexto_sp, entra->contexto_sp);
+
+    contexto_retoma();
+    em_tratador = tratador;
+}
+
+#else
+
+void contexto_cria(task_t *task, char *pilha, void (*inicio)(void*), void *arg){
+
+    getcontext(&task->context);             //Incializa com contexto atual
+    task->context.uc_stack.ss_sp = pilha;
+    task->context.uc_stack.ss_size = STACKSIZE;
+    task->context.uc_stack.ss_flags = 0;
+    task->context.uc_link = 0;
+    makecontext(&task->context, (void (*)()) inicio, 1, arg);
+}
+
+void contexto_troca(task_t *sai, task_t *entra){
+
+    swapcontext(&sai->context, &entra->context);
+}
+
+#endif
@@ -20,6 +20,7 @@
 
 void queue_append(queue_t **queue, queue_t *elem) {
 
+#ifndef PP_SEM_VERIFICACOES
     //Exceptions
     if (!queue) {
         printf("Fila está vazia.\n");
@@ -33,6 +34,7 @@ void queue_append(queue_t **queue, queue_t *elem) {
         printf("Este elemento já está em uma fila.\n");
         return;
     }
+#endif
 
     if (!*queue) { //Caso a fila esteja vazia, adiciona elemento a fila
         *queue = elem;
@@ -66,8 +68,12 @@ void queue_append(queue_t **queue, queue_t *elem) {
 
 queue_t *queue_remove(queue_t **queue, queue_t *elem) {
 
-
-
+#ifdef PP_SEM_VERIFICACOES
+    //Sem verificações (VERIFICACOES=0): o elemento é desligado direto, sem
+    //percorrer a fila para conferir que pertence a ela
+    queue_unlink(queue, elem);
+    return elem;
+#else
     queue_t* verso;
     queue_t* frente;
 
@@ -129,9 +135,26 @@ queue_t *queue_remove(queue_t **queue, queue_t *elem) {
 
     printf("Elemento não encontrado.\n");
     return NULL;
+#endif
 
 };
 
+//------------------------------------------------------------------------------
+// Remove o elemento da fila sem verificações, em tempo constante.
+
+void queue_unlink(queue_t **queue, queue_t *elem) {
+
+    if (elem->next == elem) {
+        *queue = NULL;
+    } else if (*queue == elem) {
+        *queue = elem->next;
+    }
+    elem->prev->next = elem->next;
+    elem->next->prev = elem->prev;
+    elem->next = NULL;
+    elem->prev = NULL;
+}
+
 //------------------------------------------------------------------------------
 // Conta o numero de elementos na fila
 // Retorno: numero de elementos na fila
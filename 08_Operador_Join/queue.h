@@ -39,6 +39,13 @@ void queue_append(queue_t **queue, queue_t *elem);
 
 queue_t *queue_remove(queue_t **queue, queue_t *elem);
 
+//------------------------------------------------------------------------------
+// Remove o elemento da fila sem nenhuma verificação, em tempo constante: quem
+// chama garante que o elemento está nesta fila (o núcleo sabe a fila de cada
+// tarefa por fila_atual).
+
+void queue_unlink(queue_t **queue, queue_t *elem);
+
 //------------------------------------------------------------------------------
 // Conta o numero de elementos na fila
 // Retorno: numero de elementos na fila
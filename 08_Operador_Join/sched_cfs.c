@@ -0,0 +1,94 @@
+// PingPongOS - PingPong Operating System
+//
+// Escalonador fair-share (semelhante ao CFS do Linux): cada tarefa acumula
+// tempo virtual de execução inversamente proporcional ao peso de sua
+// prioridade estática, e a próxima tarefa é a de menor tempo virtual,
+// mantida em um heap mínimo (escolha O(1), inserção e remoção O(log n)).
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "pingpong.h"
+#include "kernel.h"
+#include "heap.h"
+
+#define CFS_PESO_0      1024        /* peso da prioridade 0 */
+
+//Peso de cada prioridade estática (de PRIO_MAX a PRIO_MIN): cada nível
+//recebe cerca de 25% a mais de processador que o nível seguinte
+static const int cfs_pesos[PRIO_MIN - PRIO_MAX + 1] = {
+ /* -20 */ 88761, 71755, 56483, 46273, 36291,
+ /* -15 */ 29154, 23254, 18705, 14949, 11916,
+ /* -10 */  9548,  7620,  6100,  4904,  3906,
+ /*  -5 */  3121,  2501,  1991,  1586,  1277,
+ /*   0 */  1024,   820,   655,   526,   423,
+ /*   5 */   335,   272,   215,   172,   137,
+ /*  10 */   110,    87,    70,    56,    45,
+ /*  15 */    36,    29,    23,    18,    15,
+ /*  20 */    12
+};
+
+count_t cfs_min_vruntime = 0;   //Menor vruntime já escalonado (monotônico)
+
+//Ordem do heap: menor vruntime primeiro, desempate pelo id (mais antiga primeiro)
+int cfs_menor(task_t *a, task_t *b){
+    if(a->vruntime != b->vruntime){
+        return a->vruntime < b->vruntime;
+    }
+    return a->id < b->id;
+}
+
+task_heap_t cfs_heap = { NULL, 0, 0, cfs_menor };   //Tarefas prontas, ordenadas por vruntime
+
+//Tarefas novas começam no tempo virtual corrente, sem vantagem sobre as demais
+void cfs_task_new(task_t *task){
+    task->vruntime = cfs_min_vruntime;
+    task->vr_marca = task->t_executado;
+    task->pos_heap = -1;
+}
+
+void cfs_enqueue(task_t *task){
+    //Uma tarefa que dormiu não acumula crédito: volta no tempo virtual corrente
+    if(task->vruntime < cfs_min_vruntime){
+        task->vruntime = cfs_min_vruntime;
+    }
+    task->vr_marca = task->t_executado;
+
+    if(heap_insert(&cfs_heap, task)){
+        perror("Erro ao aumentar o heap do escalonador: ");
+        exit(-1);
+    }
+}
+
+void cfs_remove(task_t *task){
+    heap_remove(&cfs_heap, task);
+}
+
+task_t *cfs_pick(){
+    task_t *next = heap_top(&cfs_heap);
+
+    if(next && next->vruntime > cfs_min_vruntime){
+        cfs_min_vruntime = next->vruntime;
+    }
+    return next;
+}
+
+//Cobra o tempo executado desde a última marca, ponderado pelo peso da prioridade
+void cfs_stop(task_t *task, int preemptada){
+    (void) preemptada;
+
+    sys_clock_t executado = task->t_executado - task->vr_marca;
+    int peso = cfs_pesos[task->prio_estat - PRIO_MAX];
+
+    task->vruntime += (count_t) executado * CFS_PESO_0 * CFS_PESO_0 / peso;
+    task->vr_marca = task->t_executado;
+}
+
+int cfs_quantum(task_t *task){
+    (void) task;
+    return QUANTUM;
+}
+
+sched_policy_t sched_cfs = {
+    "cfs", cfs_task_new, cfs_enqueue, cfs_remove, cfs_pick, cfs_stop, cfs_quantum
+};
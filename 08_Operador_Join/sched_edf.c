@@ -0,0 +1,147 @@
+// PingPongOS - PingPong Operating System
+//
+// Classe de tempo real com escalonamento por deadline mais próximo (EDF).
+// Cada tarefa da classe recebe "orçamento" ms de processador a cada
+// "período" ms. As tarefas com orçamento ficam em um heap ordenado pelo
+// deadline absoluto e executam antes de qualquer tarefa comum; as que
+// esgotaram o orçamento (ou encerraram o trabalho com task_yield) aguardam
+// em edf_espera até o início do próximo período.
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "pingpong.h"
+#include "kernel.h"
+#include "heap.h"
+#include "queue.h"
+
+//Ordem do heap: deadline mais próximo primeiro, desempate pelo id
+int edf_menor(task_t *a, task_t *b){
+    if(a->rt_deadline != b->rt_deadline){
+        return a->rt_deadline < b->rt_deadline;
+    }
+    return a->id < b->id;
+}
+
+task_heap_t edf_heap = { NULL, 0, 0, edf_menor };  //Tarefas de tempo real com orçamento
+task_t *edf_espera = NULL;                          //Tarefas de tempo real aguardando o próximo período
+sys_clock_t edf_liberacao = 0;                      //Menor deadline entre as tarefas de edf_espera
+
+//Avança o deadline para o primeiro período ainda não vencido e renova o orçamento
+void edf_novo_periodo(task_t *task){
+    sys_clock_t agora = systime();
+
+    do{
+        task->rt_deadline += task->rt_periodo;
+    }while(task->rt_deadline <= agora);
+
+    task->rt_restante = task->rt_orcamento;
+    task->rt_esgotado = 0;
+}
+
+void edf_enqueue(task_t *task){
+    if(heap_insert(&edf_heap, task)){
+        perror("Erro ao aumentar o heap de tempo real: ");
+        exit(-1);
+    }
+}
+
+void edf_remove(task_t *task){
+    heap_remove(&edf_heap, task);
+}
+
+//A tarefa espera até o seu deadline, quando começa o próximo período
+void edf_throttle(task_t *task){
+    if(!edf_espera || task->rt_deadline < edf_liberacao){
+        edf_liberacao = task->rt_deadline;
+    }
+    queue_append((queue_t **) &edf_espera, (queue_t *) task);
+    task->fila_atual = (queue_t **) &edf_espera;
+}
+
+//Libera as tarefas cujo período recomeçou e retorna a de deadline mais próximo
+task_t *edf_pick(){
+    sys_clock_t agora = systime();
+
+    if(edf_espera && agora >= edf_liberacao){
+        task_t *task = edf_espera;
+        task_t *fim = edf_espera->prev;
+        int ultima;
+
+        edf_liberacao = ~0U;
+        do{
+            task_t *prox = task->next;
+            ultima = (task == fim);
+
+            if(agora >= task->rt_deadline){
+                if(task->rt_esgotado){      //O trabalho anterior não terminou dentro do orçamento
+                    task->rt_perdas++;
+                }
+                edf_novo_periodo(task);
+                task_set_ready(task);       //Sai de edf_espera e entra no heap
+            }
+            else if(task->rt_deadline < edf_liberacao){
+                edf_liberacao = task->rt_deadline;
+            }
+            task = prox;
+        }while(!ultima);
+    }
+
+    //Um trabalho que ainda aguarda no heap após seu deadline o perdeu
+    task_t *next = heap_top(&edf_heap);
+    while(next && next->rt_deadline <= agora){
+        next->rt_perdas++;
+        edf_novo_periodo(next);
+        heap_update(&edf_heap, next);
+        next = heap_top(&edf_heap);
+    }
+
+    return next;
+}
+
+//Consome um tick (PP_TICK_MS) do orçamento; retorna 1 se a tarefa deve deixar o processador
+int edf_tick(task_t *task){
+    if(task->rt_restante > PP_TICK_MS){
+        task->rt_restante -= PP_TICK_MS;
+        return 0;
+    }
+    task->rt_restante = 0;
+    task->rt_esgotado = 1;
+    return 1;
+}
+
+//Coloca a tarefa (ou a tarefa atual) na classe de tempo real
+int task_set_deadline (task_t *task, unsigned int period, unsigned int budget){
+
+    if(!task){                       //Para uma tarefa nula, será alterada a tarefa em execução
+        task = tarefa_atual;
+    }
+    if(task->task_dono == SISTEMA || task->status == FINALIZADO){
+        return -1;
+    }
+    if(period && (!budget || budget > period)){
+        return -1;
+    }
+
+    preempt_disable();
+
+    //Uma tarefa pronta precisa trocar de fila (heap de deadlines ou fila comum)
+    int pronta = (task->status == PRONTO && task->fila_atual);
+    if(pronta){
+        task_queue_leave(task);
+    }
+
+    task->rt_periodo = period;
+    task->rt_orcamento = budget;
+    task->rt_restante = budget;
+    task->rt_deadline = systime() + period;
+    task->rt_esgotado = 0;
+
+    if(pronta){
+        task_set_ready(task);
+    }
+
+    preempt_enable();
+
+    return 0;
+}
@@ -0,0 +1,71 @@
+// PingPongOS - PingPong Operating System
+//
+// Escalonador de filas multinível com realimentação (MLFQ): tarefas que
+// esgotam o quantum descem de nível e recebem quanta maiores; tarefas que
+// liberam o processador antes (task_yield, suspensão) permanecem no nível.
+
+#include "pingpong.h"
+#include "kernel.h"
+#include "queue.h"
+
+#define MLFQ_NIVEIS     4       /* quantidade de níveis (0 é o de maior prioridade) */
+#define MLFQ_BOOST      1000    /* ms entre promoções de todas as tarefas ao nível 0 */
+
+task_t *mlfq_filas[MLFQ_NIVEIS];    //Uma fila circular de prontas por nível
+sys_clock_t mlfq_ultimo_boost = 0;  //Instante da última promoção geral
+
+//Toda tarefa nova começa no nível mais alto
+void mlfq_task_new(task_t *task){
+    task->nivel = 0;
+}
+
+void mlfq_enqueue(task_t *task){
+    queue_append((queue_t **) &mlfq_filas[task->nivel], (queue_t *) task);
+}
+
+void mlfq_remove(task_t *task){
+    queue_remove((queue_t **) &mlfq_filas[task->nivel], (queue_t *) task);
+}
+
+//Promove todas as tarefas prontas ao nível 0, evitando inanição das tarefas longas
+void mlfq_boost(){
+    for(int i = 1; i < MLFQ_NIVEIS; i++){
+        while(mlfq_filas[i]){
+            task_t *task = mlfq_filas[i];
+            queue_remove((queue_t **) &mlfq_filas[i], (queue_t *) task);
+            task->nivel = 0;
+            queue_append((queue_t **) &mlfq_filas[0], (queue_t *) task);
+        }
+    }
+    mlfq_ultimo_boost = systime();
+}
+
+//Primeira tarefa do nível mais alto não vazio (round-robin dentro do nível)
+task_t *mlfq_pick(){
+    if(systime() - mlfq_ultimo_boost >= MLFQ_BOOST){
+        mlfq_boost();
+    }
+
+    for(int i = 0; i < MLFQ_NIVEIS; i++){
+        if(mlfq_filas[i]){
+            return mlfq_filas[i];
+        }
+    }
+    return NULL;
+}
+
+//Quem esgotou o quantum desce um nível; quem bloqueou ou cedeu o processador fica
+void mlfq_stop(task_t *task, int preemptada){
+    if(preemptada && task->nivel < MLFQ_NIVEIS - 1){
+        task->nivel++;
+    }
+}
+
+//Cada nível abaixo dobra o quantum
+int mlfq_quantum(task_t *task){
+    return QUANTUM << task->nivel;
+}
+
+sched_policy_t sched_mlfq = {
+    "mlfq", mlfq_task_new, mlfq_enqueue, mlfq_remove, mlfq_pick, mlfq_stop, mlfq_quantum
+};
@@ -0,0 +1,214 @@
+// PingPongOS - PingPong Operating System
+//
+// Decodifica um rastreamento salvo por pingpong_trace_dump (ou PINGPONG_TRACE)
+// em texto, um evento por linha: instante em microssegundos desde o primeiro
+// registro, tarefa e descrição do evento. Com -c, gera JSON no formato de
+// rastreamento do Chrome (chrome://tracing, ui.perfetto.dev): uma trilha por
+// tarefa com os intervalos em execução, marcas de criação, saída, suspensão e
+// retomada, e setas de cada task_join até a saída da tarefa aguardada.
+//
+// uso: tracedump [-c] <arquivo>
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "pp_trace.h"
+
+#define DESCONHECIDA    0x7fffffff  /* tarefa em execução antes da primeira troca registrada */
+#define NINGUEM         0x7ffffffe  /* a tarefa em execução encerrou e a próxima troca não veio */
+
+//Converte o instante de um registro em nanossegundos
+double trace_converte(trace_cabecalho_t *cab, uint64_t instante){
+    if(cab->instante1 == cab->instante0){
+        return 0;
+    }
+    return cab->ns0 + ((double) instante - cab->instante0) * (cab->ns1 - cab->ns0) / (cab->instante1 - cab->instante0);
+}
+
+void trace_descreve(trace_reg_t *r){
+
+    switch(r->evento){
+        case TR_INIT:      printf("sistema inicializado\n"); break;
+        case TR_CRIA:      printf("criada com prioridade %d e quantum %d\n", r->a, r->b); break;
+        case TR_SAIDA:     printf("encerrada com código %d após %d ms de processador\n", r->a, r->b); break;
+        case TR_TROCA:     printf("troca de contexto -> %d (ativação %d)\n", r->a, r->b); break;
+        case TR_SUSPENDE:  printf("suspensa\n"); break;
+        case TR_RETOMA:    printf("pronta para execução\n"); break;
+        case TR_CEDE:      printf("cede o processador\n"); break;
+        case TR_ESCOLHE:   printf("escolhida pelo escalonador (%d prontas)\n", r->a); break;
+        case TR_TICK:      printf("tick: %d ticks restantes, %d ms de processador\n", r->a, r->b); break;
+        case TR_DORME:     printf("dorme até %u ms\n", (unsigned) r->a); break;
+        case TR_JOIN:      printf("aguarda a tarefa %d\n", r->a); break;
+        case TR_JOIN_FIM:  printf("retornou de %d com código %d\n", r->a, r->b); break;
+        case TR_DESACOPLA: printf("desacoplada\n"); break;
+        case TR_OCIOSO:    printf("despachante ocioso até %u ms\n", (unsigned) r->a); break;
+        case TR_CANCELA:   printf("cancelada pela tarefa %d\n", r->a); break;
+        default:           printf("evento %d (%d, %d)\n", r->evento, r->a, r->b);
+    }
+}
+
+// exportação para o formato do Chrome =========================================
+
+// join ainda sem a saída da tarefa aguardada
+typedef struct trace_join_t
+{
+    int tarefa;             //Tarefa que chamou task_join
+    int alvo;               //Tarefa aguardada
+    int id;                 //Identificador da seta
+} trace_join_t ;
+
+int chrome_primeiro = 1;            //Nenhum evento escrito ainda (controle das vírgulas)
+int *chrome_tarefas = NULL;         //Tarefas que já têm trilha
+int chrome_ntarefas = 0;
+
+//Inicia um evento JSON; a trilha de cada tarefa é a "thread" id + 1 (o despachante é -1)
+void chrome_evento(const char *fase, const char *nome, int tarefa, double us){
+    printf("%s\n{\"ph\":\"%s\",\"name\":\"%s\",\"pid\":1,\"tid\":%d,\"ts\":%.3f",
+           chrome_primeiro ? "" : ",", fase, nome, tarefa + 1, us);
+    chrome_primeiro = 0;
+}
+
+//Dá nome à trilha da tarefa na primeira vez em que aparece
+void chrome_trilha(int tarefa){
+
+    for(int i = 0; i < chrome_ntarefas; i++){
+        if(chrome_tarefas[i] == tarefa){
+            return;
+        }
+    }
+    chrome_tarefas = realloc(chrome_tarefas, (chrome_ntarefas + 1) * sizeof(int));
+    chrome_tarefas[chrome_ntarefas++] = tarefa;
+
+    chrome_evento("M", "thread_name", tarefa, 0);
+    if(tarefa < 0){
+        printf(",\"args\":{\"name\":\"despachante\"}}");
+    }
+    else{
+        printf(",\"args\":{\"name\":\"tarefa %d\"}}", tarefa);
+    }
+    chrome_evento("M", "thread_sort_index", tarefa, 0);
+    printf(",\"args\":{\"sort_index\":%d}}", tarefa + 1);
+}
+
+//Intervalo em que a tarefa esteve executando
+void chrome_execucao(int tarefa, double inicio, double fim){
+    chrome_trilha(tarefa);
+    chrome_evento("X", "executando", tarefa, inicio);
+    printf(",\"dur\":%.3f}", fim - inicio);
+}
+
+//Marca instantânea na trilha da tarefa
+void chrome_marca(const char *nome, int tarefa, double us, int a, int b){
+    chrome_trilha(tarefa);
+    chrome_evento("i", nome, tarefa, us);
+    printf(",\"s\":\"t\",\"args\":{\"a\":%d,\"b\":%d}}", a, b);
+}
+
+//Converte os registros em JSON do Chrome
+void trace_chrome(FILE *f, trace_cabecalho_t *cab){
+
+    trace_join_t *joins = NULL;
+    int njoins = 0, seta = 0;
+
+    trace_reg_t r;
+    double inicio = -1, us = 0;
+    double desde = 0;                   //Início da execução da tarefa atual
+    int atual = DESCONHECIDA;           //Tarefa em execução (desconhecida até a primeira troca)
+
+    printf("{\"displayTimeUnit\":\"ms\",\"traceEvents\":[");
+    while(fread(&r, sizeof(r), 1, f) == 1){
+        double ns = trace_converte(cab, r.instante);
+        if(inicio < 0){
+            inicio = ns;
+        }
+        us = (ns - inicio) / 1000;
+
+        switch(r.evento){
+            case TR_TROCA:
+                if(atual != DESCONHECIDA && atual != NINGUEM){
+                    chrome_execucao(atual, desde, us);
+                }
+                else if(atual == DESCONHECIDA){
+                    chrome_execucao(r.tarefa, 0, us);   //Executava desde o início do rastreamento
+                }
+                atual = r.a;
+                desde = us;
+                break;
+            case TR_CRIA:      chrome_marca("criada", r.tarefa, us, r.a, r.b); break;
+            case TR_SUSPENDE:  chrome_marca("suspensa", r.tarefa, us, r.a, r.b); break;
+            case TR_RETOMA:    chrome_marca("retomada", r.tarefa, us, r.a, r.b); break;
+            case TR_CANCELA:   chrome_marca("cancelada", r.tarefa, us, r.a, r.b); break;
+            case TR_JOIN:
+                chrome_marca("join", r.tarefa, us, r.a, r.b);
+                joins = realloc(joins, (njoins + 1) * sizeof(trace_join_t));
+                joins[njoins].tarefa = r.tarefa;
+                joins[njoins].alvo = r.a;
+                joins[njoins].id = ++seta;
+                njoins++;
+                chrome_evento("s", "join", r.tarefa, us);
+                printf(",\"cat\":\"join\",\"id\":%d}", seta);
+                break;
+            case TR_SAIDA:
+                if(r.tarefa == atual){          //task_exit não registra a troca: a execução acaba aqui
+                    chrome_execucao(atual, desde, us);
+                    atual = NINGUEM;
+                }
+                chrome_marca("saída", r.tarefa, us, r.a, r.b);
+                for(int i = 0; i < njoins; i++){    //Fecha as setas de quem aguardava esta tarefa
+                    if(joins[i].alvo == r.tarefa){
+                        chrome_evento("f", "join", r.tarefa, us);
+                        printf(",\"cat\":\"join\",\"id\":%d,\"bp\":\"e\"}", joins[i].id);
+                        joins[i--] = joins[--njoins];
+                    }
+                }
+                break;
+        }
+    }
+    if(atual != DESCONHECIDA && atual != NINGUEM){
+        chrome_execucao(atual, desde, us);
+    }
+    printf("\n]}\n");
+    free(joins);
+}
+
+int main(int argc, char *argv[]){
+
+    int chrome = argc == 3 && !strcmp(argv[1], "-c");
+    if(argc != 2 && !chrome){
+        fprintf(stderr, "uso: %s [-c] <arquivo>\n", argv[0]);
+        return 1;
+    }
+
+    FILE *f = fopen(argv[argc - 1], "rb");
+    if(!f){
+        perror("Erro ao abrir o rastreamento: ");
+        return 1;
+    }
+
+    trace_cabecalho_t cab;
+    if(fread(&cab, sizeof(cab), 1, f) != 1 || memcmp(cab.magico, TRACE_MAGICO, sizeof(cab.magico))){
+        fprintf(stderr, "%s: não é um rastreamento do PingPongOS\n", argv[argc - 1]);
+        return 1;
+    }
+
+    if(chrome){
+        trace_chrome(f, &cab);
+        fclose(f);
+        return 0;
+    }
+
+    trace_reg_t r;
+    double inicio = -1;
+    while(fread(&r, sizeof(r), 1, f) == 1){
+        double ns = trace_converte(&cab, r.instante);
+        if(inicio < 0){
+            inicio = ns;
+        }
+        printf("%12.3f us  tarefa %3d  ", (ns - inicio) / 1000, r.tarefa);
+        trace_descreve(&r);
+    }
+
+    fclose(f);
+    return 0;
+}